@@ -0,0 +1,378 @@
+#include "state-wrapper.hpp"
+#include "game-generator/game-generator.hpp"
+#include "service/hint-handler.hpp"
+#include "service/move-handler.hpp"
+#include "constants.hpp"
+#include "utility.hpp"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+    std::atomic<quint64> allocationsCount{};
+}
+
+void* operator new(std::size_t size)
+{
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+
+    if(const auto pointer {std::malloc(size ? size : 1)})
+        return pointer;
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+class EngineBenchmark
+{
+public:
+
+    QJsonArray run();
+
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    template<typename Operation>
+    void measure(const QString& name, quint32 boardSize, Operation&& operation);
+
+    template<typename Setup, typename Operation>
+    void measureWithSetup(const QString& name, quint32 boardSize, Setup&& setup, Operation&& operation);
+
+    void report(const QString& name,
+                 quint32 boardSize,
+                 quint64 iterations,
+                 Clock::duration elapsed,
+                 quint64 allocations,
+                 std::optional<quint64> levelsCount = {});
+
+    void prepareLevel(quint32 boardSize);
+    void startLevel();
+
+    void benchmarkSlides(quint32 boardSize);
+    void benchmarkGenerationSteps(quint32 boardSize);
+    void benchmarkGeneration(quint32 boardSize);
+    void benchmarkHintSearch(quint32 boardSize);
+    void benchmarkMoves(quint32 boardSize);
+
+    static inline constexpr std::array<quint32, 4> kBoardSizes {8, 12, 16, 32};
+    static inline constexpr quint32 kSeed {0x1e27a};
+    static inline constexpr std::chrono::milliseconds kMinDuration {250};
+    static inline constexpr std::chrono::milliseconds kGenerationDuration {2000};
+    static inline constexpr quint64 kMaxIterations {1 << 24};
+
+    GameStateMaintainer m_state;
+    GameGenerator m_generator;
+    QJsonArray m_results;
+};
+
+QJsonArray EngineBenchmark::run()
+{
+    for(const auto boardSize : kBoardSizes)
+    {
+        benchmarkGenerationSteps(boardSize);
+        benchmarkSlides(boardSize);
+        benchmarkHintSearch(boardSize);
+        benchmarkMoves(boardSize);
+        benchmarkGeneration(boardSize);
+    }
+
+    return m_results;
+}
+
+template<typename Operation>
+void EngineBenchmark::measure(const QString& name, quint32 boardSize, Operation&& operation)
+{
+    operation();
+
+    quint64 iterations {1};
+    Clock::duration elapsed{};
+    quint64 allocations{};
+
+    while(true)
+    {
+        const auto allocationsBefore {allocationsCount.load(std::memory_order_relaxed)};
+        const auto start {Clock::now()};
+
+        for(quint64 i{}; i < iterations; ++i)
+            operation();
+
+        elapsed = Clock::now() - start;
+        allocations = allocationsCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        if(elapsed >= kMinDuration || iterations >= kMaxIterations)
+            break;
+
+        iterations *= 2;
+    }
+
+    report(name, boardSize, iterations, elapsed, allocations);
+}
+
+template<typename Setup, typename Operation>
+void EngineBenchmark::measureWithSetup(const QString& name, quint32 boardSize, Setup&& setup, Operation&& operation)
+{
+    quint64 iterations{};
+    Clock::duration elapsed{};
+    quint64 allocations{};
+
+    while(elapsed < kMinDuration && iterations < kMaxIterations)
+    {
+        setup();
+
+        const auto allocationsBefore {allocationsCount.load(std::memory_order_relaxed)};
+        const auto start {Clock::now()};
+
+        operation();
+
+        elapsed += Clock::now() - start;
+        allocations += allocationsCount.load(std::memory_order_relaxed) - allocationsBefore;
+        ++iterations;
+    }
+
+    report(name, boardSize, iterations, elapsed, allocations);
+}
+
+void EngineBenchmark::report(const QString& name,
+                              quint32 boardSize,
+                              quint64 iterations,
+                              Clock::duration elapsed,
+                              quint64 allocations,
+                              std::optional<quint64> levelsCount)
+{
+    const auto elapsedNs {std::chrono::duration<double, std::nano>(elapsed).count()};
+
+    QJsonObject result;
+    result["name"] = name;
+    result["board"] = QString("%1x%1").arg(boardSize);
+    result["iterations"] = static_cast<qint64>(iterations);
+    result["ns_per_op"] = elapsedNs / iterations;
+    result["allocations_per_op"] = static_cast<double>(allocations) / iterations;
+
+    if(levelsCount)
+        result["levels_per_sec"] = elapsedNs ? levelsCount.value() * 1e9 / elapsedNs : 0.0;
+
+    m_results.append(result);
+    std::fprintf(stderr, "%-26s %2ux%-2u %14.1f ns/op\n", qPrintable(name), boardSize, boardSize, elapsedNs / iterations);
+}
+
+void EngineBenchmark::prepareLevel(quint32 boardSize)
+{
+    InertiaUtility::seedRandomEngine(kSeed + boardSize);
+
+    m_state.setRowsCount(boardSize, false);
+    m_state.setColumnsCount(boardSize, false);
+    m_state.resetCells();
+
+    m_generator.placeBall();
+    m_generator.buildUpWalls();
+    m_generator.plantMines();
+    m_generator.placeGems();
+
+    const auto candidates {m_generator.stopCandidateCells()};
+    const auto selectionsModel {m_generator.generateStopsSelectionsModel(candidates.size(), true)};
+    std::vector<Definitions::Position> selection;
+
+    for(std::size_t i{}; i < candidates.size(); ++i)
+        if(selectionsModel[i])
+            selection.push_back(candidates[i]);
+
+    m_generator.applyStopPattern(selection);
+}
+
+void EngineBenchmark::startLevel()
+{
+    m_state.cells() = m_state.initialCells();
+    m_state.gemsCount() = m_state.gemsPositions().size();
+    m_state.remainingGemsCount() = m_state.gemsCount();
+    m_state.findHintCandidateGems();
+    m_state.publishBoard();
+}
+
+void EngineBenchmark::benchmarkSlides(quint32 boardSize)
+{
+    prepareLevel(boardSize);
+    startLevel();
+
+    std::vector<Definitions::Position> restCells;
+
+    for(quint32 rowIndex{}; rowIndex < boardSize; ++rowIndex)
+        for(quint32 columnIndex{}; columnIndex < boardSize; ++columnIndex)
+            if(m_state.cellAt(rowIndex, columnIndex) == Definitions::CellType::Stop)
+                restCells.emplace_back(rowIndex, columnIndex);
+
+    std::size_t restCellIndex{};
+    std::size_t directionIndex{};
+
+    measure("finalDestinationPlusTrace", boardSize, [&]
+    {
+        m_state.finalDestinationPlusTrace(restCells[restCellIndex], Constants::kAllDirections[directionIndex]);
+
+        if(++directionIndex == Constants::kAllDirections.size())
+        {
+            directionIndex = 0;
+            restCellIndex = (restCellIndex + 1) % restCells.size();
+        }
+    });
+}
+
+void EngineBenchmark::benchmarkGenerationSteps(quint32 boardSize)
+{
+    prepareLevel(boardSize);
+
+    const auto ballPos {m_state.ballPos()};
+
+    measure("visitableCells", boardSize, [&]
+    {
+        m_generator.visitableCells(ballPos);
+    });
+
+    const auto stoppedByCells {m_generator.visitableCells(ballPos).second};
+
+    measure("checkSolvability", boardSize, [&]
+    {
+        m_generator.checkSolvability(stoppedByCells);
+    });
+
+    std::vector<std::vector<bool>> properCells;
+    std::vector<Definitions::Position> walls;
+
+    measureWithSetup("placeObstaclesHelper", boardSize, [&]
+    {
+        m_state.resetCells();
+        m_generator.placeBall();
+        walls.clear();
+        properCells = m_generator.obstaclesInitialCandidates(walls, false);
+    },
+    [&]
+    {
+        m_generator.placeObstaclesHelper(properCells, walls, false);
+    });
+}
+
+void EngineBenchmark::benchmarkGeneration(quint32 boardSize)
+{
+    InertiaUtility::seedRandomEngine(kSeed + boardSize);
+
+    m_state.setRowsCount(boardSize, false);
+    m_state.setColumnsCount(boardSize, false);
+
+    quint64 attempts{};
+    quint64 levelsCount{};
+    const auto allocationsBefore {allocationsCount.load(std::memory_order_relaxed)};
+    const auto start {Clock::now()};
+
+    while(Clock::now() - start < kGenerationDuration)
+    {
+        const auto boardVersion {m_state.boardVersion()};
+
+        m_generator.resetStopParam();
+        m_generator.initializeModel();
+
+        ++attempts;
+
+        if(m_state.boardVersion() != boardVersion)
+            ++levelsCount;
+    }
+
+    report("initializeModel",
+           boardSize,
+           attempts,
+           Clock::now() - start,
+           allocationsCount.load(std::memory_order_relaxed) - allocationsBefore,
+           levelsCount);
+}
+
+void EngineBenchmark::benchmarkHintSearch(quint32 boardSize)
+{
+    prepareLevel(boardSize);
+    startLevel();
+
+    HintHandler hintHandler;
+    hintHandler.ensureDistanceField();
+
+    const auto stopGraph {hintHandler.m_distanceField.stopGraph()};
+    const auto blockedStops {hintHandler.m_distanceField.blockedStops()};
+    const auto ballCellId {m_state.cellId(m_state.ballPos())};
+    const auto& gemsPositions {m_state.gemsPositions()};
+
+    if(gemsPositions.empty())
+        return;
+
+    std::size_t gemIndex{};
+
+    measure("shortestWayToGem", boardSize, [&]
+    {
+        hintHandler.shortestWayToGem(*stopGraph, blockedStops, ballCellId, m_state.cellId(gemsPositions[gemIndex]));
+        gemIndex = (gemIndex + 1) % gemsPositions.size();
+    });
+}
+
+void EngineBenchmark::benchmarkMoves(quint32 boardSize)
+{
+    prepareLevel(boardSize);
+    startLevel();
+
+    MoveHandler moveHandler;
+    std::size_t directionIndex{};
+
+    measureWithSetup("moveBall", boardSize, [&]
+    {
+        const auto ballPos {m_state.ballPos()};
+
+        if(!m_state.remainingGemsCount() || m_state.cellAt(ballPos.rowIndex, ballPos.columnIndex) == Definitions::CellType::Exploded)
+            moveHandler.restartGame();
+
+        directionIndex = (directionIndex + 3) % Constants::kAllDirections.size();
+    },
+    [&]
+    {
+        moveHandler.moveBall(Constants::kAllDirections[directionIndex]);
+    });
+}
+
+
+int main(int argc, char* argv[])
+{
+    EngineBenchmark benchmark;
+    const auto json {QJsonDocument{QJsonObject{{"benchmarks", benchmark.run()}}}.toJson()};
+
+    if(argc < 2)
+    {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+        return 0;
+    }
+
+    QFile file{argv[1]};
+
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        std::fprintf(stderr, "Could not open the file %s for writing the results into\n", argv[1]);
+        return 1;
+    }
+
+    file.write(json);
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "board-data.hpp"
+
+
+BoardData::BoardData(QByteArray cells,
+                     quint32 rowsCount,
+                     quint32 columnsCount,
+                     quint64 version,
+                     bool fullUpdate,
+                     QList<QRect> changedRanges) :
+                     m_cells(std::move(cells)),
+                     m_rowsCount(rowsCount),
+                     m_columnsCount(columnsCount),
+                     m_version(version),
+                     m_fullUpdate(fullUpdate),
+                     m_changedRanges(std::move(changedRanges))
+{
+
+}
+
+QByteArray BoardData::cells() const
+{
+    return m_cells;
+}
+
+quint32 BoardData::rowsCount() const
+{
+    return m_rowsCount;
+}
+
+quint32 BoardData::columnsCount() const
+{
+    return m_columnsCount;
+}
+
+quint64 BoardData::version() const
+{
+    return m_version;
+}
+
+bool BoardData::fullUpdate() const
+{
+    return m_fullUpdate;
+}
+
+QList<QRect> BoardData::changedRanges() const
+{
+    return m_changedRanges;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QRect>
+#include <qobjectdefs.h>
+
+
+class BoardData
+{
+    Q_GADGET
+
+    Q_PROPERTY(QByteArray cells READ cells CONSTANT FINAL)
+    Q_PROPERTY(quint32 rowsCount READ rowsCount CONSTANT FINAL)
+    Q_PROPERTY(quint32 columnsCount READ columnsCount CONSTANT FINAL)
+    Q_PROPERTY(quint64 version READ version CONSTANT FINAL)
+    Q_PROPERTY(bool fullUpdate READ fullUpdate CONSTANT FINAL)
+    Q_PROPERTY(QList<QRect> changedRanges READ changedRanges CONSTANT FINAL)
+
+public:
+
+    BoardData() = default;
+    BoardData(QByteArray cells,
+              quint32 rowsCount,
+              quint32 columnsCount,
+              quint64 version,
+              bool fullUpdate,
+              QList<QRect> changedRanges);
+    BoardData(const BoardData&) = default;
+
+    QByteArray cells() const;
+    quint32 rowsCount() const;
+    quint32 columnsCount() const;
+    quint64 version() const;
+    bool fullUpdate() const;
+    QList<QRect> changedRanges() const;
+
+private:
+
+    QByteArray m_cells;
+    quint32 m_rowsCount{};
+    quint32 m_columnsCount{};
+    quint64 m_version{};
+    bool m_fullUpdate{true};
+    QList<QRect> m_changedRanges;
+};
@@ -74,15 +74,6 @@ Q_NAMESPACE
         };
     }
 
-#include <QtQml/qqmlregistration.h>
-
-    class InertiaDefinitions : public QObject
-    {
-        Q_OBJECT
-        QML_ELEMENT
-        QML_EXTENDED_NAMESPACE(Definitions)
-    };
-
     Q_DECLARE_METATYPE(Definitions::CellType)
     Q_DECLARE_METATYPE(Definitions::MovementDirection)
     Q_DECLARE_METATYPE(Definitions::Hint)
@@ -2,12 +2,13 @@
 #include "state-wrapper.hpp"
 #include "constants.hpp"
 #include "utility.hpp"
+#include "scratch-arena.hpp"
+#include "game-generator/level-metrics.hpp"
+#include "service/engine-stats.hpp"
+#include "service/engine-trace.hpp"
 
-#include <QTimer>
-#include <QCoreApplication>
 
 #include <random>
-#include <thread>
 
 
 void GameGenerator::generateAllGames(quint32 rowsCount,
@@ -20,17 +21,10 @@ void GameGenerator::generateAllGames(quint32 rowsCount,
     initializeModel(true, filePath.mid(8), gamesCount);
 }
 
-void GameGenerator::initializeModel(bool storeInFile,
+bool GameGenerator::initializeModel(bool storeInFile,
                                      const QString& filePath,
                                      std::optional<quint64> toBeGeneratedGamesCount)
 {
-    auto stopsSelectortimer {createStopsSelectorTimer(storeInFile)};
-
-    if(!storeInFile)
-        StateWrapper::instance().state()->beginResetModel();
-
-    QTextStream* stream {};
-
     if(storeInFile)
     {
         m_file.setFileName(filePath);
@@ -38,76 +32,119 @@ void GameGenerator::initializeModel(bool storeInFile,
         if(!m_file.open(QIODevice::WriteOnly))
             throw std::runtime_error{std::format("Could not open the file {} for writing game data into", filePath.toStdString())};
 
-        stream = new QTextStream(&m_file);
-    }
+        quint64 totalGamesGenerated {};
 
-    std::optional<quint64> gamesCountOnlyStopsVar{};
+        {
+            QTextStream stream{&m_file};
+            totalGamesGenerated = generateGames(stream, toBeGeneratedGamesCount.value());
+        }
 
-    if(storeInFile)
-        gamesCountOnlyStopsVar = std::max(1ULL, toBeGeneratedGamesCount.value() / 100);
+        StateWrapper::instance().state()->notifyGameGenerationCompletion(totalGamesGenerated);
+        m_file.close();
+        m_packIndex.save(PackIndex::indexPathFor(filePath));
 
-    else
-        toBeGeneratedGamesCount = 1;
+        StateWrapper::instance().state()->updatePaths(StateWrapper::instance().state()->rowsCount(),
+                                                       StateWrapper::instance().state()->columnsCount(),
+                                                       filePath);
+        return true;
+    }
 
-    quint64 totalGamesGenerated {};
+    StateWrapper::instance().state()->resetCells();
 
-    while(toBeGeneratedGamesCount > 0)
     {
-        StateWrapper::instance().state()->resetCells();
+        INERTIA_STATS_SCOPE(Layout);
 
         placeBall();
         buildUpWalls();
         plantMines();
         placeGems();
+    }
 
-        const auto gamesGenerated {placeStops(stopsSelectortimer, stream, gamesCountOnlyStopsVar)};
+    if(!placeStops(stopsSelectionTimeoutFor(false)))
+        return false;
 
-        if(!(storeInFile || gamesGenerated))
-            return;
+    StateWrapper::instance().state()->publishBoard();
+    return true;
+}
 
-        if(storeInFile)
-        {
-            toBeGeneratedGamesCount =
-                (toBeGeneratedGamesCount.value() < gamesGenerated) ?
-                    0 : toBeGeneratedGamesCount.value() - gamesGenerated;
+quint64 GameGenerator::generateGames(QTextStream& stream, quint64 gamesCount)
+{
+    const auto stopsSelectionTimeout {stopsSelectionTimeoutFor(true)};
+    const auto gamesCountPerLayout {std::max(1ULL, gamesCount / 100)};
+    quint64 totalGamesGenerated {};
 
-            totalGamesGenerated += gamesGenerated;
-        }
+    m_packIndex.clear();
 
-        else
-            toBeGeneratedGamesCount = 0;
-    }
+    while(totalGamesGenerated < gamesCount)
+    {
+        StateWrapper::instance().state()->resetCells();
 
-    if(!storeInFile)
-        StateWrapper::instance().state()->endResetModel();
+        {
+            INERTIA_STATS_SCOPE(Layout);
 
-    else
-    {
-        StateWrapper::instance().state()->notifyGameGenerationCompletion(totalGamesGenerated);
-        delete stream;
-        stream = nullptr;
-        m_file.close();
+            placeBall();
+            buildUpWalls();
+            plantMines();
+            placeGems();
+        }
 
-        StateWrapper::instance().state()->updatePaths(StateWrapper::instance().state()->rowsCount(),
-                                                       StateWrapper::instance().state()->columnsCount(),
-                                                       filePath);
+        totalGamesGenerated += placeStops(stopsSelectionTimeout,
+                                          &stream,
+                                          std::min(gamesCountPerLayout, gamesCount - totalGamesGenerated));
     }
 
-    delete stopsSelectortimer;
-    stopsSelectortimer = nullptr;
+    return totalGamesGenerated;
 }
 
-void GameGenerator::newGameFromFile(quint32 rowsCount, quint32 columnsCount)
+const PackIndex& GameGenerator::packIndex() const
+{
+    return m_packIndex;
+}
+
+void GameGenerator::newGameFromFile(quint32 rowsCount,
+                                     quint32 columnsCount,
+                                     std::optional<std::pair<qint32, qint32>> optimalMovesRange)
 {
     auto filePath {StateWrapper::instance().state()->pathForDimensions(rowsCount, columnsCount)};
 
     if(!filePath.size())
         return;
 
-    QFile file{filePath};
+    const auto gamesData {packEntries(filePath)};
 
-    if(!file.open(QIODevice::ReadOnly))
-        throw std::runtime_error{std::format("Could not open file {} for reading.", filePath.toStdString())};
+    if(!gamesData.size())
+    {
+        StateWrapper::instance().state()->setRowsCount(rowsCount);
+        StateWrapper::instance().state()->setColumnsCount(columnsCount);
+        StateWrapper::instance().state()->resetCells();
+        StateWrapper::instance().state()->publishBoard();
+        return;
+    }
+
+    auto& generator {InertiaUtility::randomEngine()};
+
+    if(optimalMovesRange)
+        if(const auto packIndex {PackIndex::load(PackIndex::indexPathFor(filePath))})
+        {
+            std::vector<quint32> candidates;
+
+            for(const auto& entry : packIndex->entriesWithin(optimalMovesRange->first, optimalMovesRange->second))
+                if(entry.entryIndex < static_cast<quint32>(gamesData.size()))
+                    candidates.push_back(entry.entryIndex);
+
+            if(candidates.size())
+            {
+                loadPackEntry(rowsCount, columnsCount, gamesData.at(candidates[generator() % candidates.size()]));
+                return;
+            }
+        }
+
+    loadPackEntry(rowsCount, columnsCount, gamesData.at(generator() % gamesData.size()));
+}
+
+void GameGenerator::loadPackEntry(quint32 rowsCount, quint32 columnsCount, QString gameData)
+{
+    INERTIA_TRACE_SCOPE("loadPackEntry");
 
     StateWrapper::instance().state()->setRowsCount(rowsCount);
     StateWrapper::instance().state()->setColumnsCount(columnsCount);
@@ -119,10 +156,24 @@ void GameGenerator::newGameFromFile(quint32 rowsCount, quint32 columnsCount)
 
     StateWrapper::instance().state()->remainingGemsCount() = gemsCount;
 
-    StateWrapper::instance().state()->beginResetModel();
-
     StateWrapper::instance().state()->resetCells();
 
+    loadGameFromData(gameData);
+
+    StateWrapper::instance().state()->onGameStart() = true;
+    StateWrapper::instance().state()->publishBoard();
+}
+
+QStringList GameGenerator::packEntries(const QString& filePath)
+{
+    INERTIA_STATS_SCOPE(PackRead);
+    INERTIA_TRACE_SCOPE("packEntries");
+
+    QFile file{filePath};
+
+    if(!file.open(QIODevice::ReadOnly))
+        throw std::runtime_error{std::format("Could not open file {} for reading.", filePath.toStdString())};
+
     QString fileContent;
 
     {
@@ -130,23 +181,20 @@ void GameGenerator::newGameFromFile(quint32 rowsCount, quint32 columnsCount)
         fileContent = stream.readAll();
     }
 
-    if(!fileContent.size())
-    {
-        StateWrapper::instance().state()->endResetModel();
-        return;
-    }
+    auto gamesData {splitPackEntries(fileContent)};
+    INERTIA_STATS_ADD(PackEntriesRead, gamesData.size());
 
-    const auto gamesData {fileContent.split('#', Qt::SkipEmptyParts)};
-    const auto gamesCount {gamesData.size() - 1};
+    return gamesData;
+}
 
-    std::random_device rd;
-    std::mt19937 generator(rd());
-    auto gameData {gamesData.at(generator() % gamesCount)};
+QStringList GameGenerator::splitPackEntries(const QString& packData)
+{
+    auto gamesData {packData.split('#', Qt::SkipEmptyParts)};
 
-    loadGameFromData(gameData);
+    if(gamesData.size())
+        gamesData.removeLast();
 
-    StateWrapper::instance().state()->onGameStart() = true;
-    StateWrapper::instance().state()->endResetModel();
+    return gamesData;
 }
 
 void GameGenerator::loadSavedGame(quint32 rowsCount,
@@ -157,9 +205,8 @@ void GameGenerator::loadSavedGame(quint32 rowsCount,
                                    QString initialCellTypesData,
                                    QString cellTypesData)
 {
-    StateWrapper::instance().state()->beginResetModel();
-
     resetGameData(rowsCount, columnsCount);
+    StateWrapper::instance().state()->initialCells() = StateWrapper::instance().state()->cells();
     auto& ballPos {StateWrapper::instance().state()->ballPos()};
     ballPos = Definitions::Position(ballPosPoint.y(), ballPosPoint.x());
     StateWrapper::instance().state()->notifyBallPosChange(ballPos);
@@ -210,7 +257,7 @@ void GameGenerator::loadSavedGame(quint32 rowsCount,
     {
         QTextStream cellsStream{&cellTypesData};
         qint16 cellTypeValue{};
-        auto& gems {StateWrapper::instance().state()->gemsPositions()};
+        auto& gems {StateWrapper::instance().state()->gemIndex()};
 
         for(quint32 rowIndex{}; rowIndex < rowsCount; ++rowIndex)
             for(quint32 columnIndex{}; columnIndex < columnsCount; ++columnIndex)
@@ -221,7 +268,7 @@ void GameGenerator::loadSavedGame(quint32 rowsCount,
 
                 if(cellType == Definitions::CellType::Gem)
                 {
-                    gems.emplace_back(rowIndex, columnIndex);
+                    gems.add(Definitions::Position(rowIndex, columnIndex));
                     ++StateWrapper::instance().state()->remainingGemsCount();
                 }
             }
@@ -229,11 +276,15 @@ void GameGenerator::loadSavedGame(quint32 rowsCount,
 
     StateWrapper::instance().state()->findHintCandidateGems();
     StateWrapper::instance().state()->onGameStart() = true;
-    StateWrapper::instance().state()->endResetModel();
+    StateWrapper::instance().state()->publishBoard();
 }
 
 void GameGenerator::storeInFile(QTextStream* file)
 {
+    INERTIA_TRACE_SCOPE("storeInFile");
+    INERTIA_STATS_SCOPE(PackWrite);
+    INERTIA_STATS_COUNT(PackEntriesWritten);
+
     const auto& ballPosition {StateWrapper::instance().state()->ballPos()};
 
     (*file) << QString("%1 %2 %3 %4 ").
@@ -258,7 +309,6 @@ void GameGenerator::storeInFile(QTextStream* file)
 
     for(quint32 rowIndex{}; rowIndex < rowsCount; ++rowIndex)
     {
-        QCoreApplication::processEvents(QEventLoop::AllEvents);
         auto& row {StateWrapper::instance().state()->initialCells().at(rowIndex)};
 
         for(auto it {row.cbegin()}; it != row.cend(); ++it)
@@ -279,10 +329,6 @@ void GameGenerator::resetGameData(quint32 rowsCount, quint32 columnsCount)
     m_stopNewGameGeneration = false;
 }
 
-// Temporary
-#include <iostream>
-//
-
 void GameGenerator::loadGameFromData(QString& gameData)
 {
     QTextStream stream{&gameData};
@@ -323,7 +369,6 @@ void GameGenerator::loadGameFromData(QString& gameData)
     }
 
     quint16 cellTypeValue{};
-    std::vector<Definitions::Position>{}.swap(StateWrapper::instance().state()->gemsPositions());
 
 
     for(quint32 rowIndex{}; rowIndex < rowsCount; ++rowIndex)
@@ -351,7 +396,7 @@ void GameGenerator::loadGameFromData(QString& gameData)
             case 4:
             {
                 *it = Definitions::CellType::Gem;
-                StateWrapper::instance().state()->gemsPositions().emplace_back(rowIndex, std::distance(row.begin(), it));
+                StateWrapper::instance().state()->gemIndex().add(Definitions::Position(rowIndex, std::distance(row.begin(), it)));
             }
             break;
 
@@ -368,6 +413,8 @@ void GameGenerator::loadGameFromData(QString& gameData)
 
 void GameGenerator::placeBall()
 {
+    INERTIA_TRACE_SCOPE("placeBall");
+
     const auto rowsCount {StateWrapper::instance().state()->rowsCount()};
     const auto columnsCount {StateWrapper::instance().state()->columnsCount()};
     auto& ballPosition {StateWrapper::instance().state()->ballPos()};
@@ -381,27 +428,29 @@ void GameGenerator::placeBall()
 
 void GameGenerator::placeObstacles(bool plantMines)
 {
-    static std::vector<Definitions::Position> walls;
-
-    auto properCells {obstaclesInitialCandidates(walls, plantMines)};
-    placeObstaclesHelper(properCells, walls, plantMines);
+    auto properCells {obstaclesInitialCandidates(m_walls, plantMines)};
+    placeObstaclesHelper(properCells, m_walls, plantMines);
 
     if(plantMines)
-        std::vector<Definitions::Position>{}.swap(walls);
+        std::vector<Definitions::Position>{}.swap(m_walls);
 }
 
 void GameGenerator::buildUpWalls()
 {
+    INERTIA_TRACE_SCOPE("buildUpWalls");
     placeObstacles(false);
 }
 
 void GameGenerator::plantMines()
 {
+    INERTIA_TRACE_SCOPE("plantMines");
     placeObstacles(true);
 }
 
 void GameGenerator::placeGems()
 {
+    INERTIA_TRACE_SCOPE("placeGems");
+
     std::vector<Definitions::Position> clearCells;
 
     const auto rowsCount {StateWrapper::instance().state()->rowsCount()};
@@ -414,13 +463,12 @@ void GameGenerator::placeGems()
                 clearCells.emplace_back(rowIndex, columnIndex);
         }
 
-    std::random_device rd;
-    std::mt19937 generator(rd());
+    auto& generator {InertiaUtility::randomEngine()};
 
     std::shuffle(clearCells.begin(), clearCells.end(), generator);
 
     StateWrapper::instance().state()->remainingGemsCount() = rowsCount * columnsCount * Constants::kCellsGemsRatio;
-    std::vector<Definitions::Position>{}.swap(StateWrapper::instance().state()->gemsPositions());
+    StateWrapper::instance().state()->gemIndex().reset(rowsCount, columnsCount);
 
     const auto remainingGemsCnt {StateWrapper::instance().state()->remainingGemsCount()};
 
@@ -434,16 +482,18 @@ void GameGenerator::placeGems()
         const auto columnIndex {pos.columnIndex};
         clearCells.pop_back();
         StateWrapper::instance().state()->cellAt(rowIndex, columnIndex) = Definitions::CellType::Gem;
-        StateWrapper::instance().state()->gemsPositions().emplace_back(rowIndex, columnIndex);
+        StateWrapper::instance().state()->gemIndex().add(Definitions::Position(rowIndex, columnIndex));
     }
 }
 
-quint64 GameGenerator::placeStops(QTimer* stopsSelectortimer,
+quint64 GameGenerator::placeStops(std::chrono::milliseconds stopsSelectionTimeout,
                                  QTextStream* fileStream,
                                  std::optional<quint64> targetedGamesCount)
 {
+    INERTIA_TRACE_SCOPE("placeStops");
+
     return generateTryStopPatterns(stopCandidateCells(),
-                                   stopsSelectortimer,
+                                   stopsSelectionTimeout,
                                    fileStream,
                                    targetedGamesCount);
 }
@@ -547,8 +597,7 @@ std::vector<Definitions::Position> GameGenerator::obstacleCandidatePositionsGene
                 result.emplace_back(rowIndex, columnIndex);
         }
 
-    std::random_device rd;
-    std::mt19937 generator(rd());
+    auto& generator {InertiaUtility::randomEngine()};
 
     std::shuffle(result.begin(), result.end(), generator);
 
@@ -570,48 +619,49 @@ std::vector<Definitions::Position> GameGenerator::stopCandidateCells() const
     return availableCells;
 }
 
-std::pair<std::optional<std::unordered_set<Definitions::Position>>, std::unordered_set<Definitions::Position>>
-GameGenerator::visitableCells(const Definitions::Position& currentPosition, bool onlyStoppedByCells) const
+std::pair<std::optional<GameGenerator::PositionSet>, GameGenerator::PositionSet>
+GameGenerator::visitableCells(const Definitions::Position& currentPosition,
+                              bool onlyStoppedByCells,
+                              std::pmr::memory_resource* resource) const
 {
-    std::optional<std::unordered_set<Definitions::Position>> visitedCells{};
+    const auto state {StateWrapper::instance().state()};
+    std::optional<PositionSet> visitedCells{};
 
     if(!onlyStoppedByCells)
-        visitedCells.emplace({currentPosition});
+    {
+        visitedCells.emplace(resource);
+        visitedCells->insert(currentPosition);
+    }
 
-    std::unordered_set<Definitions::Position> stoppedByCells {currentPosition};
-    std::vector<Definitions::Position> traces{currentPosition};
+    PositionSet stoppedByCells {resource};
+    stoppedByCells.insert(currentPosition);
 
-    while(traces.size())
-    {
-        const auto tracesCount {traces.size()};
+    std::pmr::vector<Definitions::Position> traces {resource};
+    traces.push_back(currentPosition);
 
-        for(quint64 i{}; i < tracesCount; ++i)
+    for(std::size_t traceIndex{}; traceIndex < traces.size(); ++traceIndex)
+    {
+        for(const auto dir : Constants::kAllDirections)
         {
-            for(const auto dir : Constants::kAllDirections)
-            {
-                const auto currentPos {traces.front()};
+            const auto currentPos {traces[traceIndex]};
+            const auto [finalPos, safeFinalPos, trace] {state->finalDestinationPlusTrace(currentPos, dir, false, true)};
 
-                auto [finalPos, safeFinalPos, trace]
-                    {StateWrapper::instance().state()->finalDestinationPlusTrace(currentPos, dir, true, true)};
+            if(!safeFinalPos || finalPos == currentPos || stoppedByCells.contains(finalPos))
+                continue;
 
-                if(!safeFinalPos || finalPos == currentPos || stoppedByCells.contains(finalPos))
-                    continue;
-
-                if(!onlyStoppedByCells)
+            if(!onlyStoppedByCells)
+                for(auto pos {currentPos}; pos != finalPos; )
                 {
-                    visitedCells->merge(trace.value());
-                    visitedCells->insert(finalPos);
+                    pos = state->nextCellPos(pos, dir).value();
+                    visitedCells->insert(pos);
                 }
 
-                stoppedByCells.insert(finalPos);
-                traces.push_back(std::move(finalPos));
-            }
-
-            traces.erase(traces.begin());
+            stoppedByCells.insert(finalPos);
+            traces.push_back(finalPos);
         }
     }
 
-    return {visitedCells, stoppedByCells};
+    return {std::move(visitedCells), std::move(stoppedByCells)};
 }
 
 void GameGenerator::visitableCellsHelper(const Definitions::Position& startPos,
@@ -688,15 +738,13 @@ void GameGenerator::applyStopPattern(const std::vector<Definitions::Position>& s
         initCells[stopPosRow][stopPosColumn] = Definitions::CellType::Stop;
 }
 
-// Temporary
-// #include <iostream>
-//
-
 quint64 GameGenerator::generateTryStopPatterns(const std::vector<Definitions::Position>& availableCells,
-                                                 QTimer* stopsSelectortimer,
+                                                 std::chrono::milliseconds stopsSelectionTimeout,
                                                  QTextStream* fileStream,
                                                  std::optional<quint64> targetedGamesCount)
 {
+    INERTIA_STATS_SCOPE(StopPatterns);
+
     const auto availableCellsCount {availableCells.size()};
     bool generateAllGames= fileStream;
     auto selectionsModel {generateStopsSelectionsModel(availableCellsCount, generateAllGames)};
@@ -704,17 +752,13 @@ quint64 GameGenerator::generateTryStopPatterns(const std::vector<Definitions::Po
     std::vector<Definitions::Position> selection;
     const auto ballPos {StateWrapper::instance().state()->ballPos()};
 
-    // Temporary
-    //std::cout << "@@@@@@@@@ Trying a new game Ball/Wall/Mine pattern ... @@@@@@@@@" << std::endl;
-    //
-
-    stopsSelectortimer->stop();
     resetStopperVar();
-    stopsSelectortimer->start();
+    const auto stopsSelectionDeadline {std::chrono::steady_clock::now() + stopsSelectionTimeout};
 
     do
     {
-        QCoreApplication::processEvents(QEventLoop::AllEvents);
+        if(std::chrono::steady_clock::now() >= stopsSelectionDeadline)
+            setStopperVar();
 
         std::vector<Definitions::Position>{}.swap(selection);
 
@@ -722,8 +766,12 @@ quint64 GameGenerator::generateTryStopPatterns(const std::vector<Definitions::Po
             if(selectionsModel[i])
                 selection.push_back(availableCells[i]);
 
+        INERTIA_STATS_COUNT(StopPatternsTried);
+
         applyStopPattern(selection);
-        const auto [vCells, stoppedByCells] {visitableCells(ballPos)};
+
+        ScratchArena arena;
+        const auto [vCells, stoppedByCells] {visitableCells(ballPos, false, arena.resource())};
 
         bool skipCurrentPattern {false};
 
@@ -731,10 +779,9 @@ quint64 GameGenerator::generateTryStopPatterns(const std::vector<Definitions::Po
 
         for(const auto& gemPos : gemPoses)
         {
-            QCoreApplication::processEvents(QEventLoop::AllEvents);
-
             if(!vCells->contains(gemPos))
             {
+                INERTIA_STATS_COUNT(PatternsRejectedUnreachableGem);
                 skipCurrentPattern = true;
                 break;
             }
@@ -746,21 +793,28 @@ quint64 GameGenerator::generateTryStopPatterns(const std::vector<Definitions::Po
         {
             std::tie(skipCurrentPattern, stuckArea) = checkSolvability(stoppedByCells);
             skipCurrentPattern = !skipCurrentPattern;
+
+            if(skipCurrentPattern)
+                INERTIA_STATS_COUNT(PatternsRejectedUnsolvable);
         }
 
         if(!skipCurrentPattern)
         {
-            // Temporary
-             std::cout << "**** A new game generated! ****" << std::endl;
-            //
-
+            INERTIA_STATS_COUNT(GamesGenerated);
             ++gamesGenerated;
 
             StateWrapper::instance().state()->stuckArea() = std::move(stuckArea);
             StateWrapper::instance().state()->stuckAreaGems() = findStuckAreaGems();
+            StateWrapper::instance().state()->findHintCandidateGems();
 
             if(generateAllGames)
             {
+                const auto state {StateWrapper::instance().state()};
+                m_packIndex.add(m_packIndex.size(), m_levelMeter.measure(*state,
+                                                                         state->initialCells(),
+                                                                         state->ballPos(),
+                                                                         state->stuckArea().size(),
+                                                                         &stoppedByCells));
                 storeInFile(fileStream);
                 std::vector<std::vector<Definitions::CellType>>{}.swap(StateWrapper::instance().state()->initialCells());
             }
@@ -779,12 +833,6 @@ quint64 GameGenerator::generateTryStopPatterns(const std::vector<Definitions::Po
 
     while (!m_stopNewGameGeneration.load() && std::prev_permutation(selectionsModel.begin(), selectionsModel.end()));
 
-    if(!generateAllGames && m_stopNewGameGeneration.load() && !gamesGenerated)
-        std::thread(&GameGenerator::newGameFromFile,
-                    this,
-                    StateWrapper::instance().state()->rowsCount(),
-                    StateWrapper::instance().state()->columnsCount()).detach();
-
     return gamesGenerated;
 }
 
@@ -801,8 +849,7 @@ std::vector<bool> GameGenerator::generateStopsSelectionsModel(std::size_t availa
         selectionsModel.resize(stopsCount, true);
         selectionsModel.resize(availableCellsCount, false);
 
-        std::random_device rd;
-        std::mt19937 generator(rd());
+        auto& generator {InertiaUtility::randomEngine()};
 
         std::shuffle(selectionsModel.begin(), selectionsModel.end(), generator);
     }
@@ -829,33 +876,26 @@ std::vector<bool> GameGenerator::generateStopsSelectionsModel(std::size_t availa
     return selectionsModel;
 }
 
-QTimer* GameGenerator::createStopsSelectorTimer(bool generateMultipleGames)
+std::chrono::milliseconds GameGenerator::stopsSelectionTimeoutFor(bool generateMultipleGames) const
 {
-    auto stopsSelectortimer {new QTimer(this)};
-
-    stopsSelectortimer->setSingleShot(true);
-    stopsSelectortimer->setTimerType(Qt::PreciseTimer);
-
     if(generateMultipleGames)
-        stopsSelectortimer->setInterval(1.8 * std::pow(1.7, StateWrapper::instance().state()->rowsCount()));
-    else
-        stopsSelectortimer->setInterval(300);
-
-    connect(stopsSelectortimer, &QTimer::timeout, this, &GameGenerator::setStopperVar);
+        return std::chrono::milliseconds{static_cast<qint64>(1.8 * std::pow(1.7, StateWrapper::instance().state()->rowsCount()))};
 
-    return stopsSelectortimer;
+    return std::chrono::milliseconds{300};
 }
 
 bool GameGenerator::isConnectedTo(const Definitions::Position& sourcePos,
                                  const Definitions::Position& targetPos) const
 {
-    std::unordered_set<Definitions::Position> alreadyChecked{};
+    ScratchArena arena;
+    PositionSet alreadyChecked {arena.resource()};
+
     return isConnectedToHelper(sourcePos, targetPos, alreadyChecked);
 }
 
 bool GameGenerator::isConnectedToHelper(const Definitions::Position& sourcePos,
                                        const Definitions::Position& targetPos,
-                                       std::unordered_set<Definitions::Position>& alreadyChecked) const
+                                       PositionSet& alreadyChecked) const
 {
     const auto& nonObsNeighbours {nonObstacleNeighbours(sourcePos, alreadyChecked)};
 
@@ -869,10 +909,10 @@ bool GameGenerator::isConnectedToHelper(const Definitions::Position& sourcePos,
                        { return isConnectedToHelper(pos, targetPos, alreadyChecked);});
 }
 
-std::vector<Definitions::Position> GameGenerator::nonObstacleNeighbours(const Definitions::Position& pos,
-                                                                        std::unordered_set<Definitions::Position>& alreadyChecked) const
+std::pmr::vector<Definitions::Position> GameGenerator::nonObstacleNeighbours(const Definitions::Position& pos,
+                                                                             PositionSet& alreadyChecked) const
 {
-    std::vector<Definitions::Position> result;
+    std::pmr::vector<Definitions::Position> result {alreadyChecked.get_allocator()};
 
     for(const auto direction : Constants::kAllDirections)
     {
@@ -899,23 +939,22 @@ void GameGenerator::resetStopperVar()
 
 void GameGenerator::setStopperVar()
 {
-    // Temporary
-    // std::cout << "$$$$$$$ m_stopNewGameGeneration set to true! $$$$$$$" << std::endl;
-    //
-
     m_stopNewGameGeneration.store(true);
 }
 
 std::pair<bool, std::unordered_set<Definitions::Position>>
-GameGenerator::checkSolvability(const std::unordered_set<Definitions::Position>& originalStoppedByCells)
+GameGenerator::checkSolvability(const PositionSet& originalStoppedByCells)
 {
+    INERTIA_STATS_SCOPE(SolvabilityCheck);
+    INERTIA_TRACE_SCOPE("checkSolvability");
+
     std::optional<Definitions::Position> stuckAreaRepresentative{};
     std::unordered_set<Definitions::Position> stuckArea;
 
     for(const auto& startPos : originalStoppedByCells)
     {
-        std::unordered_set<Definitions::Position> stoppedByCells;
-        std::tie(std::ignore, stoppedByCells) = visitableCells(startPos, true);
+        ScratchArena arena;
+        const auto stoppedByCells {visitableCells(startPos, true, arena.resource()).second};
 
         for(const auto& pos : originalStoppedByCells)
         {
@@ -948,7 +987,8 @@ std::vector<Definitions::Position> GameGenerator::findStuckAreaGems() const
     std::vector<Definitions::Position> result;
     const auto& stuckAreaRep {*StateWrapper::instance().state()->stuckArea().begin()};
 
-    auto [vCells, stoppedByCells] {visitableCells(stuckAreaRep)};
+    ScratchArena arena;
+    auto [vCells, stoppedByCells] {visitableCells(stuckAreaRep, false, arena.resource())};
 
     const auto& gemPoses {StateWrapper::instance().state()->gemsPositions()};
 
@@ -1,18 +1,21 @@
 #pragma once
 
 #include "common-definitions.hpp"
+#include "game-generator/pack-index.hpp"
 
 #include <QFile>
-#include <unordered_set>
-
 
-class QTimer;
+#include <chrono>
+#include <memory_resource>
+#include <unordered_set>
 
 
 class GameGenerator : public QObject
 {
     Q_OBJECT
 
+    friend class EngineBenchmark;
+
 public:
 
     void generateAllGames(quint32 rowsCount,
@@ -20,11 +23,19 @@ public:
                            quint64 gamesCount,
                            const QString& filePath);
 
-    void initializeModel(bool storeInFile = false,
+    bool initializeModel(bool storeInFile = false,
                           const QString& filePath = {},
                           std::optional<quint64> toBeGeneratedGamesCount = {});
 
-    void newGameFromFile(quint32 rowsCount, quint32 columnsCount);
+    quint64 generateGames(QTextStream& stream, quint64 gamesCount);
+    const PackIndex& packIndex() const;
+
+    void newGameFromFile(quint32 rowsCount,
+                          quint32 columnsCount,
+                          std::optional<std::pair<qint32, qint32>> optimalMovesRange = {});
+    void loadPackEntry(quint32 rowsCount, quint32 columnsCount, QString gameData);
+    static QStringList packEntries(const QString& filePath);
+    static QStringList splitPackEntries(const QString& packData);
 
     void loadSavedGame(quint32 rowsCount,
                         quint32 columnsCount,
@@ -43,13 +54,15 @@ public slots:
 
 private:
 
+    using PositionSet = std::pmr::unordered_set<Definitions::Position>;
+
     void placeBall();
     void placeObstacles(bool plantMines);
     void buildUpWalls();
     void plantMines();
     void placeGems();
 
-    quint64 placeStops(QTimer* stopsSelectortimer,
+    quint64 placeStops(std::chrono::milliseconds stopsSelectionTimeout,
                         QTextStream* fileStream = {},
                         std::optional<quint64> targetedGamesCount = {});
 
@@ -62,8 +75,10 @@ private:
     std::vector<Definitions::Position> obstacleCandidatePositionsGenerator(const std::vector<std::vector<bool>>& properCells);
     std::vector<Definitions::Position> stopCandidateCells() const;
 
-    std::pair<std::optional<std::unordered_set<Definitions::Position>>, std::unordered_set<Definitions::Position>>
-    visitableCells(const Definitions::Position& currentPosition, bool onlyStoppedByCells = false) const;
+    std::pair<std::optional<PositionSet>, PositionSet>
+    visitableCells(const Definitions::Position& currentPosition,
+                    bool onlyStoppedByCells = false,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
     void visitableCellsHelper(const Definitions::Position& startPos,
                                 std::unordered_set<Definitions::Position>& processedSourcePositions,
@@ -74,7 +89,7 @@ private:
     void applyStopPattern(const std::vector<Definitions::Position>& stopPattern);
 
     quint64 generateTryStopPatterns(const std::vector<Definitions::Position>& availableCells,
-                                      QTimer* stopsSelectortimer,
+                                      std::chrono::milliseconds stopsSelectionTimeout,
                                       QTextStream* fileStream = {},
                                       std::optional<quint64> targetedGamesCount = {});
 
@@ -85,19 +100,22 @@ private:
 
     bool isConnectedToHelper(const Definitions::Position& sourcePos,
                               const Definitions::Position& targetPos,
-                              std::unordered_set<Definitions::Position>& alreadyChecked) const;
+                              PositionSet& alreadyChecked) const;
 
-    std::vector<Definitions::Position> nonObstacleNeighbours(const Definitions::Position& pos,
-                                                               std::unordered_set<Definitions::Position>& alreadyChecked) const;
+    std::pmr::vector<Definitions::Position> nonObstacleNeighbours(const Definitions::Position& pos,
+                                                                    PositionSet& alreadyChecked) const;
     void resetGameData(quint32 rowsCount, quint32 columnsCount);
     void loadGameFromData(QString& gameData);
     void resetStopperVar();
-    QTimer* createStopsSelectorTimer(bool generateMultipleGames);
+    std::chrono::milliseconds stopsSelectionTimeoutFor(bool generateMultipleGames) const;
     void storeInFile(QTextStream* file);
     std::pair<bool, std::unordered_set<Definitions::Position>>
-    checkSolvability(const std::unordered_set<Definitions::Position>& originalStoppedByCells);
+    checkSolvability(const PositionSet& originalStoppedByCells);
     std::vector<Definitions::Position> findStuckAreaGems() const;
 
     QFile m_file{};
+    PackIndex m_packIndex;
+    LevelMeter m_levelMeter;
+    std::vector<Definitions::Position> m_walls;
     std::atomic_bool m_stopNewGameGeneration {false};
 };
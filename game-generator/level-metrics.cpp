@@ -0,0 +1,100 @@
+#include "level-metrics.hpp"
+#include "game-state-maintainer.hpp"
+#include "constants.hpp"
+
+
+LevelMetrics LevelMeter::measure(const GameStateMaintainer& state,
+                                 const std::vector<std::vector<Definitions::CellType>>& cells,
+                                 const Definitions::Position& ballPos,
+                                 std::size_t stuckAreaSize,
+                                 const std::pmr::unordered_set<Definitions::Position>* restCells)
+{
+    m_stopGraph.build(state, cells);
+
+    LevelMetrics result;
+    result.stuckAreaSize = stuckAreaSize;
+
+    if(restCells)
+    {
+        m_restCellIds.clear();
+
+        for(const auto& pos : *restCells)
+            m_restCellIds.push_back(state.cellId(pos));
+    }
+
+    else
+        collectRestCells(state.cellId(ballPos));
+
+    m_countedMines.assign(m_stopGraph.cellsCount(), false);
+    quint32 movesCount{};
+
+    for(const auto cellId : m_restCellIds)
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+        {
+            if(!m_stopGraph.slide(cellId, dirIndex).safe)
+            {
+                auto pos {state.cellPosition(cellId)};
+
+                while(const auto nextPos {state.nextCellPos(pos, Constants::kAllDirections[dirIndex])})
+                {
+                    pos = nextPos.value();
+
+                    if(cells[pos.rowIndex][pos.columnIndex] != Definitions::CellType::Mine)
+                        continue;
+
+                    if(const auto mineCellId {state.cellId(pos)}; !m_countedMines[mineCellId])
+                    {
+                        m_countedMines[mineCellId] = true;
+                        ++result.minesNearPathsCount;
+                    }
+
+                    break;
+                }
+
+                continue;
+            }
+
+            if(m_stopGraph.isMove(cellId, dirIndex))
+                ++movesCount;
+        }
+
+    result.restCellsCount = m_restCellIds.size();
+    result.branchingFactor = static_cast<float>(movesCount) / result.restCellsCount;
+
+    m_gemCellIds.clear();
+
+    for(quint32 rowIndex{}; rowIndex < state.rowsCount(); ++rowIndex)
+        for(quint32 columnIndex{}; columnIndex < state.columnsCount(); ++columnIndex)
+            if(cells[rowIndex][columnIndex] == Definitions::CellType::Gem)
+                m_gemCellIds.push_back(state.cellId(Definitions::Position(rowIndex, columnIndex)));
+
+    if(m_gemCellIds.size() <= LevelSolver::kMaxGemsCount)
+        if(const auto solution {m_solver.solve(m_stopGraph, state.cellId(ballPos), m_gemCellIds)})
+            result.optimalMovesCount = solution->size();
+
+    return result;
+}
+
+void LevelMeter::collectRestCells(quint32 ballCellId)
+{
+    m_reachedCells.assign(m_stopGraph.cellsCount(), false);
+    m_restCellIds.clear();
+
+    m_reachedCells[ballCellId] = true;
+    m_restCellIds.push_back(ballCellId);
+
+    for(std::size_t i{}; i < m_restCellIds.size(); ++i)
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+        {
+            const auto cellId {m_restCellIds[i]};
+
+            if(!m_stopGraph.isMove(cellId, dirIndex))
+                continue;
+
+            if(const auto destination {m_stopGraph.slide(cellId, dirIndex).destination}; !m_reachedCells[destination])
+            {
+                m_reachedCells[destination] = true;
+                m_restCellIds.push_back(destination);
+            }
+        }
+}
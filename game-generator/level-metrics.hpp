@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common-definitions.hpp"
+#include "service/level-solver.hpp"
+#include "stop-graph.hpp"
+
+#include <memory_resource>
+#include <unordered_set>
+#include <vector>
+
+
+class GameStateMaintainer;
+
+
+struct LevelMetrics
+{
+    qint32 optimalMovesCount{-1};
+    float branchingFactor{};
+    quint32 restCellsCount{};
+    quint32 stuckAreaSize{};
+    quint32 minesNearPathsCount{};
+};
+
+
+class LevelMeter
+{
+public:
+
+    LevelMetrics measure(const GameStateMaintainer& state,
+                         const std::vector<std::vector<Definitions::CellType>>& cells,
+                         const Definitions::Position& ballPos,
+                         std::size_t stuckAreaSize,
+                         const std::pmr::unordered_set<Definitions::Position>* restCells = {});
+
+private:
+
+    void collectRestCells(quint32 ballCellId);
+
+    StopGraph m_stopGraph;
+    LevelSolver m_solver;
+    std::vector<quint32> m_restCellIds;
+    std::vector<bool> m_reachedCells;
+    std::vector<bool> m_countedMines;
+    std::vector<quint32> m_gemCellIds;
+};
@@ -0,0 +1,121 @@
+#include "pack-index.hpp"
+#include "service/engine-stats.hpp"
+#include "service/engine-trace.hpp"
+
+#include <QFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <format>
+
+
+void PackIndex::clear()
+{
+    m_entries.clear();
+}
+
+void PackIndex::add(quint32 entryIndex, const LevelMetrics& metrics)
+{
+    m_entries.push_back({entryIndex, metrics});
+}
+
+std::size_t PackIndex::size() const
+{
+    return m_entries.size();
+}
+
+std::span<const PackIndex::Entry> PackIndex::entries() const
+{
+    return m_entries;
+}
+
+std::span<const PackIndex::Entry> PackIndex::entriesWithin(qint32 minOptimalMovesCount, qint32 maxOptimalMovesCount) const
+{
+    const auto first {std::lower_bound(m_entries.cbegin(), m_entries.cend(), minOptimalMovesCount,
+                                       [](const Entry& entry, qint32 movesCount)
+                                       {
+                                           return entry.metrics.optimalMovesCount < movesCount;
+                                       })};
+
+    const auto last {std::upper_bound(first, m_entries.cend(), maxOptimalMovesCount,
+                                      [](qint32 movesCount, const Entry& entry)
+                                      {
+                                          return movesCount < entry.metrics.optimalMovesCount;
+                                      })};
+
+    return {first, last};
+}
+
+void PackIndex::save(const QString& filePath)
+{
+    INERTIA_STATS_SCOPE(PackWrite);
+    INERTIA_TRACE_SCOPE("savePackIndex");
+
+    sort();
+
+    QFile file{filePath};
+
+    if(!file.open(QIODevice::WriteOnly))
+        throw std::runtime_error{std::format("Could not open the file {} for writing the pack index into", filePath.toStdString())};
+
+    QTextStream stream{&file};
+    stream << m_entries.size() << '\n';
+
+    for(const auto& [entryIndex, metrics] : m_entries)
+        stream << QString("%1 %2 %3 %4 %5 %6\n").
+                  arg(entryIndex).
+                  arg(metrics.optimalMovesCount).
+                  arg(metrics.branchingFactor).
+                  arg(metrics.restCellsCount).
+                  arg(metrics.stuckAreaSize).
+                  arg(metrics.minesNearPathsCount);
+}
+
+std::optional<PackIndex> PackIndex::load(const QString& filePath)
+{
+    INERTIA_STATS_SCOPE(PackRead);
+    INERTIA_TRACE_SCOPE("loadPackIndex");
+
+    QFile file{filePath};
+
+    if(!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QTextStream stream{&file};
+    quint64 entriesCount{};
+    stream >> entriesCount;
+
+    if(entriesCount > static_cast<quint64>(file.size()) / kMinEntryLength)
+        return {};
+
+    PackIndex result;
+    result.m_entries.resize(entriesCount);
+
+    for(auto& [entryIndex, metrics] : result.m_entries)
+        stream >> entryIndex
+               >> metrics.optimalMovesCount
+               >> metrics.branchingFactor
+               >> metrics.restCellsCount
+               >> metrics.stuckAreaSize
+               >> metrics.minesNearPathsCount;
+
+    if(stream.status() != QTextStream::Ok)
+        return {};
+
+    result.sort();
+
+    return result;
+}
+
+QString PackIndex::indexPathFor(const QString& packFilePath)
+{
+    return packFilePath + ".index";
+}
+
+void PackIndex::sort()
+{
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& lhs, const Entry& rhs)
+    {
+        return lhs.metrics.optimalMovesCount < rhs.metrics.optimalMovesCount;
+    });
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "level-metrics.hpp"
+
+#include <QString>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+
+class PackIndex
+{
+public:
+
+    struct Entry
+    {
+        quint32 entryIndex{};
+        LevelMetrics metrics;
+    };
+
+    void clear();
+    void add(quint32 entryIndex, const LevelMetrics& metrics);
+    std::size_t size() const;
+    std::span<const Entry> entries() const;
+
+    std::span<const Entry> entriesWithin(qint32 minOptimalMovesCount, qint32 maxOptimalMovesCount) const;
+
+    void save(const QString& filePath);
+    static std::optional<PackIndex> load(const QString& filePath);
+    static QString indexPathFor(const QString& packFilePath);
+
+private:
+
+    void sort();
+
+    static inline constexpr quint64 kMinEntryLength {12};
+
+    std::vector<Entry> m_entries;
+};
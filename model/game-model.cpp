@@ -2,16 +2,20 @@
 #include "state-wrapper.hpp"
 #include "game-generator/game-generator.hpp"
 #include "service/move-handler.hpp"
+#include "service/engine-scheduler.hpp"
+#include "service/ready-level-queue.hpp"
+#include "service/engine-stats.hpp"
+#include "service/engine-trace.hpp"
 
-#include <QThread>
+#include <QPointer>
 
 
 using namespace Definitions;
 
 
 InertiaModel::InertiaModel(QObject *parent) : QAbstractTableModel(parent),
-                                                m_gameGenerator(std::make_unique<GameGenerator>()),
-                                                m_moveHandler(std::make_unique<MoveHandler>())
+                                                m_moveHandler(std::make_unique<MoveHandler>()),
+                                                m_readyLevels(std::make_shared<ReadyLevelQueue>())
 {
     qRegisterMetaType<InertiaModel*>("InertiaModel *");
 }
@@ -36,28 +40,36 @@ void InertiaModel::setBallPosition(QPointF pos)
 int InertiaModel::rowCount(const QModelIndex& parentIndex) const
 {
     Q_UNUSED(parentIndex);
-    return StateWrapper::instance().state()->rowsCount();
+    return StateWrapper::instance().state()->publishedBoard().rowsCount;
 }
 
 int InertiaModel::columnCount(const QModelIndex& parentIndex) const
 {
     Q_UNUSED(parentIndex);
-    return StateWrapper::instance().state()->columnsCount();
+    return StateWrapper::instance().state()->publishedBoard().columnsCount;
 }
 
 QVariant InertiaModel::data(const QModelIndex& index, int role) const
 {
-    return StateWrapper::instance().state()->data(index, role);
+    const auto& board {StateWrapper::instance().state()->publishedBoard()};
+
+    if(index.row() < 0 || index.row() >= board.rowsCount || index.column() < 0 || index.column() >= board.columnsCount)
+        return {};
+
+    if(role == Qt::DisplayRole)
+        return static_cast<CellType>(board.cells[index.row() * board.columnsCount + index.column()]);
+
+    return {};
 }
 
 quint32 InertiaModel::rowsCount() const
 {
-    return StateWrapper::instance().state()->rowsCount();
+    return StateWrapper::instance().state()->publishedBoard().rowsCount;
 }
 
 quint32 InertiaModel::columnsCount() const
 {
-    return StateWrapper::instance().state()->columnsCount();
+    return StateWrapper::instance().state()->publishedBoard().columnsCount;
 }
 
 QPointF InertiaModel::ballPosition() const
@@ -65,18 +77,25 @@ QPointF InertiaModel::ballPosition() const
     return StateWrapper::instance().state()->ballPositionPoint();
 }
 
+quint64 InertiaModel::boardDataVersion() const
+{
+    return StateWrapper::instance().state()->boardDataVersion();
+}
+
 void InertiaModel::initializeModel(bool storeInFile,
                                     const QString& filePath,
                                     std::optional<quint64> toBeGeneratedGamesCount)
 {
-    auto thread {QThread::create(&GameGenerator::initializeModel,
-                                 m_gameGenerator.get(),
-                                 storeInFile,
-                                 filePath,
-                                 toBeGeneratedGamesCount)};
+    const auto state {StateWrapper::instance().state()};
 
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start(QThread::TimeCriticalPriority);
+    if(!storeInFile && startReadyLevel(state->rowsCount(), state->columnsCount()))
+        return;
+
+    scheduleLoad(TaskPriority::Load, [storeInFile, filePath, toBeGeneratedGamesCount]
+    {
+        GameGenerator generator;
+        return generator.initializeModel(storeInFile, filePath, toBeGeneratedGamesCount);
+    });
 }
 
 MovementResult InertiaModel::moveBall(MovementDirection direction)
@@ -84,23 +103,44 @@ MovementResult InertiaModel::moveBall(MovementDirection direction)
     return m_moveHandler->moveBall(direction);
 }
 
+MovementSequenceResult InertiaModel::moveBallSequence(QList<MovementDirection> directions)
+{
+    return m_moveHandler->moveBallSequence(directions);
+}
+
 void InertiaModel::generateAllGames(quint32 rowsCount,
                                      quint32 columnsCount,
                                      quint64 gamesCount,
                                      const QString& filePath)
 {
-    m_gameGenerator->generateAllGames(rowsCount, columnsCount, gamesCount, filePath);
+    scheduleLoad(TaskPriority::Background, [rowsCount, columnsCount, gamesCount, filePath]
+    {
+        GameGenerator generator;
+        generator.generateAllGames(rowsCount, columnsCount, gamesCount, filePath);
+        return true;
+    });
 }
 
-void InertiaModel::newGameFromFile(quint32 rowsCount, quint32 columnsCount)
+void InertiaModel::newGameFromFile(quint32 rowsCount,
+                                    quint32 columnsCount,
+                                    qint32 minOptimalMovesCount,
+                                    qint32 maxOptimalMovesCount)
 {
-    auto thread {QThread::create(&GameGenerator::newGameFromFile,
-                                 m_gameGenerator.get(),
-                                 rowsCount,
-                                 columnsCount)};
+    std::optional<std::pair<qint32, qint32>> optimalMovesRange;
+
+    if(minOptimalMovesCount >= 0 || maxOptimalMovesCount >= 0)
+        optimalMovesRange = std::pair{std::max(minOptimalMovesCount, 0),
+                                      maxOptimalMovesCount >= 0 ? maxOptimalMovesCount : std::numeric_limits<qint32>::max()};
+
+    else if(startReadyLevel(rowsCount, columnsCount))
+        return;
 
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start(QThread::TimeCriticalPriority);
+    scheduleLoad(TaskPriority::Load, [rowsCount, columnsCount, optimalMovesRange]
+    {
+        GameGenerator generator;
+        generator.newGameFromFile(rowsCount, columnsCount, optimalMovesRange);
+        return true;
+    });
 }
 
 void InertiaModel::undo(QPointF preMovePos, QList<QPointF> pickedGems)
@@ -108,6 +148,38 @@ void InertiaModel::undo(QPointF preMovePos, QList<QPointF> pickedGems)
     m_moveHandler->undo(preMovePos, pickedGems);
 }
 
+bool InertiaModel::undoMove()
+{
+    return m_moveHandler->undoLastMove();
+}
+
+bool InertiaModel::redoMove()
+{
+    return m_moveHandler->redoMove();
+}
+
+bool InertiaModel::canUndo() const
+{
+    return m_moveHandler->canUndo();
+}
+
+bool InertiaModel::canRedo() const
+{
+    return m_moveHandler->canRedo();
+}
+
+void InertiaModel::startSessionRecording()
+{
+    m_moveHandler->startSessionRecording();
+}
+
+QByteArray InertiaModel::stopSessionRecording()
+{
+    const auto log {m_moveHandler->stopSessionRecording()};
+
+    return log ? log->serialize() : QByteArray{};
+}
+
 QString InertiaModel::stuckAreaToWrite() const
 {
     return StateWrapper::instance().state()->stuckAreaToWrite();
@@ -136,26 +208,31 @@ void InertiaModel::loadSavedGame(quint32 rowsCount,
                                   QString initialCellTypesData,
                                   QString cellTypesData)
 {
-    auto thread {QThread::create(&GameGenerator::loadSavedGame,
-                                 m_gameGenerator.get(),
-                                 rowsCount,
-                                 columnsCount,
-                                 ballPos,
-                                 stuckAreaData,
-                                 stuckAreaGemsData,
-                                 initialCellTypesData,
-                                 cellTypesData)};
-
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start(QThread::TimeCriticalPriority);
+    scheduleLoad(TaskPriority::Load,
+                 [rowsCount,
+                  columnsCount,
+                  ballPos,
+                  stuckAreaData,
+                  stuckAreaGemsData,
+                  initialCellTypesData,
+                  cellTypesData]
+    {
+        GameGenerator generator;
+        generator.loadSavedGame(rowsCount,
+                                columnsCount,
+                                ballPos,
+                                stuckAreaData,
+                                stuckAreaGemsData,
+                                initialCellTypesData,
+                                cellTypesData);
+        return true;
+    });
 }
 
 void InertiaModel::restartGame()
 {
-    m_gameGenerator->resetStopParam();
-    auto thread {QThread::create(&GameStateMaintainer::restartGame, StateWrapper::instance().state())};
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-    thread->start(QThread::TimeCriticalPriority);
+    m_moveHandler->restartGame();
+    precomputeHint();
 }
 
 void InertiaModel::announceBallPosition(QPointF ballPos)
@@ -163,24 +240,164 @@ void InertiaModel::announceBallPosition(QPointF ballPos)
     StateWrapper::instance().state()->announceBallPosition(ballPos);
 }
 
-void InertiaModel::hint()
+void InertiaModel::hint(qint32 timeBudgetMs, qint64 memoryBudgetBytes)
+{
+    HintBudget budget;
+
+    if(timeBudgetMs >= 0)
+        budget.time = std::chrono::milliseconds{timeBudgetMs};
+
+    if(memoryBudgetBytes >= 0)
+        budget.memoryBytes = static_cast<std::size_t>(memoryBudgetBytes);
+
+    m_moveHandler->hint(budget);
+}
+
+void InertiaModel::solve()
 {
-    m_moveHandler->hint();
+    m_moveHandler->solve();
 }
 
-void InertiaModel::notifyDataChange(const QModelIndex& topLeft, const QModelIndex& downRight)
+BoardData InertiaModel::boardData(quint64 sinceVersion) const
 {
-    emit dataChanged(topLeft, downRight);
+    return StateWrapper::instance().state()->boardData(sinceVersion);
 }
 
-void InertiaModel::notifyBallPosChange(const Definitions::Position& ballPos)
+void InertiaModel::setThreadBudget(quint32 threadBudget)
 {
-    emit ballPositionChanged(QPointF(ballPos.columnIndex, ballPos.rowIndex));
+    EngineScheduler::instance().setThreadBudget(threadBudget);
+}
+
+QVariantMap InertiaModel::stats() const
+{
+    const auto snapshot {EngineStats::instance().snapshot()};
+    const auto toString {[](std::string_view name) { return QString::fromLatin1(name.data(), name.size()); }};
+    QVariantMap counters;
+    QVariantMap timers;
+
+    for(std::size_t i{}; i < EngineStatsSnapshot::kCountersCount; ++i)
+        counters[toString(EngineStats::counterName(static_cast<StatCounter>(i)))] = snapshot.counters[i];
+
+    for(std::size_t i{}; i < EngineStatsSnapshot::kTimersCount; ++i)
+        timers[toString(EngineStats::timerName(static_cast<StatTimer>(i)))] =
+            QVariantMap{{"count", snapshot.timerCounts[i]}, {"totalMs", snapshot.timerNanoseconds[i] / 1e6}};
+
+    return {{"enabled", EngineStats::kEnabled}, {"counters", counters}, {"timers", timers}};
+}
+
+void InertiaModel::resetStats()
+{
+    EngineStats::instance().reset();
+}
+
+void InertiaModel::startTrace()
+{
+    EngineTrace::instance().start();
 }
 
-void InertiaModel::notifyBallPosChange(const QPointF& ballPos)
+bool InertiaModel::stopTrace(const QString& filePath)
 {
-    emit ballPositionChanged(ballPos);
+    try
+    {
+        EngineTrace::instance().stop(filePath);
+    }
+
+    catch(const std::exception&)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void InertiaModel::scheduleLoad(TaskPriority priority, std::function<bool()> load)
+{
+    auto loadState {std::make_shared<GameStateMaintainer>(false)};
+    loadState->prepareLoad(*StateWrapper::instance().state());
+
+    EngineScheduler::instance().submit(priority, [load = std::move(load), loadState, model = QPointer<InertiaModel>(this)]
+    {
+        bool loaded {};
+        std::optional<QString> failure;
+
+        try
+        {
+            const ThreadStateScope threadState {loadState.get()};
+            loaded = load();
+        }
+
+        catch(const std::exception& exception)
+        {
+            failure = QString{exception.what()};
+        }
+
+        if(model)
+            QMetaObject::invokeMethod(model, [model, loadState, loaded, failure]
+            {
+                if(failure)
+                {
+                    emit model->loadFailed(failure.value());
+                    return;
+                }
+
+                StateWrapper::instance().state()->adoptLoadedLevel(*loadState);
+
+                if(loaded)
+                    model->precomputeHint();
+
+                else
+                    model->loadPackLevel(loadState->rowsCount(), loadState->columnsCount());
+            }, Qt::QueuedConnection);
+    });
+}
+
+void InertiaModel::loadPackLevel(quint32 rowsCount, quint32 columnsCount)
+{
+    scheduleLoad(TaskPriority::Load, [rowsCount, columnsCount]
+    {
+        GameGenerator generator;
+        generator.newGameFromFile(rowsCount, columnsCount);
+        return true;
+    });
+}
+
+void InertiaModel::precomputeHint()
+{
+    m_moveHandler->precomputeHint(this);
+}
+
+bool InertiaModel::startReadyLevel(quint32 rowsCount, quint32 columnsCount)
+{
+    const auto state {StateWrapper::instance().state()};
+    const auto level {m_readyLevels->take(rowsCount, columnsCount, state->gamesDataFilesPath())};
+
+    if(!level)
+        return false;
+
+    state->setRowsCount(rowsCount, false);
+    state->setColumnsCount(columnsCount, false);
+    level->applyLevel(*state);
+    state->notifyBallPosChange(state->ballPos());
+    precomputeHint();
+
+    return true;
+}
+
+void InertiaModel::notifyCellsChange(const CellRect& rect)
+{
+    emit dataChanged(index(rect.topRowIndex, rect.leftColumnIndex),
+                     index(rect.bottomRowIndex, rect.rightColumnIndex),
+                     {Qt::DisplayRole});
+}
+
+void InertiaModel::notifyBoardDataChange(quint64 version)
+{
+    emit boardDataChanged(version);
+}
+
+void InertiaModel::notifyBallPosChange(const Definitions::Position& ballPos)
+{
+    emit ballPositionChanged(QPointF(ballPos.columnIndex, ballPos.rowIndex));
 }
 
 void InertiaModel::notifyGameCompletion()
@@ -198,18 +415,20 @@ void InertiaModel::notifyColumnsCountChange(quint32 newColumnsCount)
     emit columnsCountChanged(newColumnsCount);
 }
 
-void InertiaModel::notifyHint(Definitions::MovementDirection moveDir)
+void InertiaModel::notifyHint(Definitions::MovementDirection moveDir, bool optimal)
 {
-    emit showHint(moveDir);
+    emit showHint(moveDir, optimal);
 }
 
 void InertiaModel::notifyDataModificationStart()
 {
+    INERTIA_TRACE_SCOPE("beginResetModel");
     beginResetModel();
 }
 
 void InertiaModel::notifyDataModificationEnd()
 {
+    INERTIA_TRACE_SCOPE("endResetModel");
     endResetModel();
 }
 
@@ -217,3 +436,8 @@ void InertiaModel::notifyGameGenerationCompletion(quint64 gamesGenerated)
 {
     emit gameGenerationCompleted(gamesGenerated);
 }
+
+void InertiaModel::notifySolution(const QList<Definitions::MovementDirection>& moves)
+{
+    emit solutionReady(moves);
+}
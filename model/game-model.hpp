@@ -1,20 +1,27 @@
 #pragma once
 
 #include "movement-result.hpp"
+#include "movement-sequence-result.hpp"
+#include "board-data.hpp"
 #include "common-definitions.hpp"
+#include "state-observer.hpp"
 
 #include <QAbstractTableModel>
 #include <QtQml/qqmlregistration.h>
 #include <QPointF>
+#include <QVariantMap>
+
+#include <functional>
 
 
 class GameStateMaintainer;
-class GameGenerator;
 class MoveHandler;
 class HintHandler;
+class ReadyLevelQueue;
+enum class TaskPriority;
 
 
-class InertiaModel : public QAbstractTableModel
+class InertiaModel : public QAbstractTableModel, public StateObserver
 {
     Q_OBJECT
     QML_ELEMENT
@@ -22,6 +29,7 @@ class InertiaModel : public QAbstractTableModel
     Q_PROPERTY(quint32 rowsCount READ rowsCount WRITE setRowsCount NOTIFY rowsCountChanged FINAL)
     Q_PROPERTY(quint32 columnsCount READ columnsCount WRITE setColumnsCount NOTIFY columnsCountChanged FINAL)
     Q_PROPERTY(QPointF ballPosition READ ballPosition WRITE setBallPosition NOTIFY ballPositionChanged FINAL)
+    Q_PROPERTY(quint64 boardDataVersion READ boardDataVersion NOTIFY boardDataChanged FINAL)
 
 public:
 
@@ -35,21 +43,32 @@ public:
     quint32 rowsCount() const;
     quint32 columnsCount() const;
     QPointF ballPosition() const;
+    quint64 boardDataVersion() const;
 
     Q_INVOKABLE void initializeModel(bool storeInFile = false,
                                       const QString& filePath = {},
                                       std::optional<quint64> toBeGeneratedGamesCount = {});
 
     Q_INVOKABLE MovementResult moveBall(Definitions::MovementDirection direction);
+    Q_INVOKABLE MovementSequenceResult moveBallSequence(QList<Definitions::MovementDirection> directions);
 
     Q_INVOKABLE void generateAllGames(quint32 rowsCount,
                                        quint32 columnsCount,
                                        quint64 gamesCount,
                                        const QString& filePath);
 
-    Q_INVOKABLE void newGameFromFile(quint32 rowsCount, quint32 columnsCount);
+    Q_INVOKABLE void newGameFromFile(quint32 rowsCount,
+                                     quint32 columnsCount,
+                                     qint32 minOptimalMovesCount = -1,
+                                     qint32 maxOptimalMovesCount = -1);
 
     Q_INVOKABLE void undo(QPointF preMovePos, QList<QPointF> pickedGems);
+    Q_INVOKABLE bool undoMove();
+    Q_INVOKABLE bool redoMove();
+    Q_INVOKABLE bool canUndo() const;
+    Q_INVOKABLE bool canRedo() const;
+    Q_INVOKABLE void startSessionRecording();
+    Q_INVOKABLE QByteArray stopSessionRecording();
     Q_INVOKABLE QString stuckAreaToWrite() const;
     Q_INVOKABLE QString stuckAreaGemsToWrite() const;
     Q_INVOKABLE QString cellValuesToWrite() const;
@@ -65,18 +84,26 @@ public:
 
     Q_INVOKABLE void restartGame();
     Q_INVOKABLE void announceBallPosition(QPointF ballPos);
-    Q_INVOKABLE void hint();
-
-    void notifyDataChange(const QModelIndex& topLeft, const QModelIndex& downRight);
-    void notifyBallPosChange(const Definitions::Position& ballPos);
-    void notifyBallPosChange(const QPointF& ballPos);
-    void notifyGameCompletion();
-    void notifyRowsCountChange(quint32 newRowsCount);
-    void notifyColumnsCountChange(quint32 newColumnsCount);
-    void notifyHint(Definitions::MovementDirection moveDir);
-    void notifyDataModificationStart();
-    void notifyDataModificationEnd();
-    void notifyGameGenerationCompletion(quint64 gamesGenerated);
+    Q_INVOKABLE void hint(qint32 timeBudgetMs = -1, qint64 memoryBudgetBytes = -1);
+    Q_INVOKABLE void solve();
+    Q_INVOKABLE BoardData boardData(quint64 sinceVersion = 0) const;
+    Q_INVOKABLE void setThreadBudget(quint32 threadBudget);
+    Q_INVOKABLE QVariantMap stats() const;
+    Q_INVOKABLE void resetStats();
+    Q_INVOKABLE void startTrace();
+    Q_INVOKABLE bool stopTrace(const QString& filePath);
+
+    void notifyCellsChange(const CellRect& rect) override;
+    void notifyBoardDataChange(quint64 version) override;
+    void notifyBallPosChange(const Definitions::Position& ballPos) override;
+    void notifyGameCompletion() override;
+    void notifyRowsCountChange(quint32 newRowsCount) override;
+    void notifyColumnsCountChange(quint32 newColumnsCount) override;
+    void notifyHint(Definitions::MovementDirection moveDir, bool optimal) override;
+    void notifyDataModificationStart() override;
+    void notifyDataModificationEnd() override;
+    void notifyGameGenerationCompletion(quint64 gamesGenerated) override;
+    void notifySolution(const QList<Definitions::MovementDirection>& moves) override;
 
 public slots:
 
@@ -89,13 +116,21 @@ signals:
     void rowsCountChanged(quint32 rowsCount);
     void columnsCountChanged(quint32 columnsCount);
     void ballPositionChanged(QPointF newPos);
+    void boardDataChanged(quint64 version);
     void gameCompleted();
     void gameGenerationCompleted(quint64 gamesGenerated);
     void stuck();
-    void showHint(Definitions::MovementDirection direction);
+    void showHint(Definitions::MovementDirection direction, bool optimal);
+    void solutionReady(QList<Definitions::MovementDirection> moves);
+    void loadFailed(QString reason);
 
 private:
 
-    std::unique_ptr<GameGenerator> m_gameGenerator{};
+    void scheduleLoad(TaskPriority priority, std::function<bool()> load);
+    void loadPackLevel(quint32 rowsCount, quint32 columnsCount);
+    void precomputeHint();
+    bool startReadyLevel(quint32 rowsCount, quint32 columnsCount);
+
     std::unique_ptr<MoveHandler> m_moveHandler{};
+    std::shared_ptr<ReadyLevelQueue> m_readyLevels{};
 };
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common-definitions.hpp"
+#include "game-state-maintainer.hpp"
+#include "movement-result.hpp"
+#include "movement-sequence-result.hpp"
+#include "board-data.hpp"
+
+#include <QtQml/qqmlregistration.h>
+
+
+class InertiaDefinitions : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_EXTENDED_NAMESPACE(Definitions)
+};
+
+struct GameStateMaintainerForeign
+{
+    Q_GADGET
+    QML_FOREIGN(GameStateMaintainer)
+    QML_NAMED_ELEMENT(GameStateMaintainer)
+};
+
+struct MovementResultForeign
+{
+    Q_GADGET
+    QML_FOREIGN(MovementResult)
+    QML_VALUE_TYPE(movementResult)
+};
+
+struct MovementSequenceResultForeign
+{
+    Q_GADGET
+    QML_FOREIGN(MovementSequenceResult)
+    QML_VALUE_TYPE(movementSequenceResult)
+};
+
+struct BoardDataForeign
+{
+    Q_GADGET
+    QML_FOREIGN(BoardData)
+    QML_VALUE_TYPE(boardData)
+};
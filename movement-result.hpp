@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QtQml/qqmlregistration.h>
 #include <QPointF>
 #include <QList>
 #include <qobjectdefs.h>
@@ -9,7 +8,6 @@
 class MovementResult
 {
     Q_GADGET
-    QML_VALUE_TYPE(movementResult)
 
     Q_PROPERTY(QPointF finalDestination READ finalDestination CONSTANT FINAL)
     Q_PROPERTY(QList<QPointF> collectedGems READ collectedGems FINAL)
@@ -0,0 +1,39 @@
+#include "movement-sequence-result.hpp"
+
+
+MovementSequenceResult::MovementSequenceResult(const QPointF& finalDest,
+                                                QList<qint32> gemsPerStep,
+                                                QList<qint32> collectedGemCellIds,
+                                                qint32 explosionIndex) :
+                                                m_finalDestination(finalDest),
+                                                m_gemsPerStep(std::move(gemsPerStep)),
+                                                m_collectedGemCellIds(std::move(collectedGemCellIds)),
+                                                m_explosionIndex(explosionIndex)
+{
+
+}
+
+QPointF MovementSequenceResult::finalDestination() const
+{
+    return m_finalDestination;
+}
+
+QList<qint32> MovementSequenceResult::gemsPerStep() const
+{
+    return m_gemsPerStep;
+}
+
+QList<qint32> MovementSequenceResult::collectedGemCellIds() const
+{
+    return m_collectedGemCellIds;
+}
+
+qint32 MovementSequenceResult::appliedMovesCount() const
+{
+    return m_gemsPerStep.size();
+}
+
+qint32 MovementSequenceResult::explosionIndex() const
+{
+    return m_explosionIndex;
+}
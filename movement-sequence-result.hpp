@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QPointF>
+#include <QList>
+#include <qobjectdefs.h>
+
+
+class MovementSequenceResult
+{
+    Q_GADGET
+
+    Q_PROPERTY(QPointF finalDestination READ finalDestination CONSTANT FINAL)
+    Q_PROPERTY(QList<qint32> gemsPerStep READ gemsPerStep CONSTANT FINAL)
+    Q_PROPERTY(QList<qint32> collectedGemCellIds READ collectedGemCellIds CONSTANT FINAL)
+    Q_PROPERTY(qint32 appliedMovesCount READ appliedMovesCount CONSTANT FINAL)
+    Q_PROPERTY(qint32 explosionIndex READ explosionIndex CONSTANT FINAL)
+
+public:
+
+    MovementSequenceResult() = default;
+    MovementSequenceResult(const QPointF& finalDest,
+                            QList<qint32> gemsPerStep,
+                            QList<qint32> collectedGemCellIds,
+                            qint32 explosionIndex);
+    MovementSequenceResult(const MovementSequenceResult&) = default;
+
+    QPointF finalDestination() const;
+    QList<qint32> gemsPerStep() const;
+    QList<qint32> collectedGemCellIds() const;
+    qint32 appliedMovesCount() const;
+    qint32 explosionIndex() const;
+
+private:
+
+    QPointF m_finalDestination;
+    QList<qint32> m_gemsPerStep;
+    QList<qint32> m_collectedGemCellIds;
+    qint32 m_explosionIndex {-1};
+};
@@ -0,0 +1,68 @@
+#include "scratch-arena.hpp"
+
+#include <algorithm>
+
+
+ScratchArena::ScratchArena() : m_buffer(takeBuffer()),
+                               m_resource(m_buffer.data.get(), m_buffer.size, &m_overflow)
+{
+
+}
+
+ScratchArena::~ScratchArena()
+{
+    m_resource.release();
+
+    if(const auto overflowBytes {m_overflow.allocatedBytes()}; overflowBytes && m_buffer.size < kMaxBufferSize)
+    {
+        m_buffer.size = std::min(m_buffer.size + overflowBytes, kMaxBufferSize);
+        m_buffer.data = std::make_unique_for_overwrite<std::byte[]>(m_buffer.size);
+    }
+
+    freeBuffers().push_back(std::move(m_buffer));
+}
+
+std::pmr::memory_resource* ScratchArena::resource()
+{
+    return &m_resource;
+}
+
+ScratchArena::Buffer ScratchArena::takeBuffer()
+{
+    auto& buffers {freeBuffers()};
+
+    if(buffers.empty())
+        return {std::make_unique_for_overwrite<std::byte[]>(kInitialBufferSize), kInitialBufferSize};
+
+    auto buffer {std::move(buffers.back())};
+    buffers.pop_back();
+
+    return buffer;
+}
+
+std::vector<ScratchArena::Buffer>& ScratchArena::freeBuffers()
+{
+    static thread_local std::vector<Buffer> buffers;
+    return buffers;
+}
+
+std::size_t ScratchArena::OverflowResource::allocatedBytes() const
+{
+    return m_allocatedBytes;
+}
+
+void* ScratchArena::OverflowResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    m_allocatedBytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void ScratchArena::OverflowResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool ScratchArena::OverflowResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
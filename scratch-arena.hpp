@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+
+class ScratchArena
+{
+public:
+
+    ScratchArena();
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    std::pmr::memory_resource* resource();
+
+private:
+
+    struct Buffer
+    {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size{};
+    };
+
+    class OverflowResource : public std::pmr::memory_resource
+    {
+    public:
+
+        std::size_t allocatedBytes() const;
+
+    private:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        std::size_t m_allocatedBytes{};
+    };
+
+    static Buffer takeBuffer();
+    static std::vector<Buffer>& freeBuffers();
+
+    static inline constexpr std::size_t kInitialBufferSize {64 * 1024};
+    static inline constexpr std::size_t kMaxBufferSize {16 * 1024 * 1024};
+
+    Buffer m_buffer;
+    OverflowResource m_overflow;
+    std::pmr::monotonic_buffer_resource m_resource;
+};
@@ -0,0 +1,271 @@
+#include "anytime-hint-search.hpp"
+#include "stop-graph.hpp"
+#include "constants.hpp"
+#include "scratch-arena.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <unordered_map>
+
+
+AnytimeHintSearch::AnytimeHintSearch(const StopGraph& stopGraph,
+                                     const std::vector<bool>& blockedStops,
+                                     const HintBudget& budget) :
+    m_stopGraph(stopGraph),
+    m_blockedStops(blockedStops),
+    m_budget(budget)
+{
+
+}
+
+std::optional<HintSearchResult> AnytimeHintSearch::search(quint32 sourceCellId, quint32 gemCellId)
+{
+    const auto cellsCount {m_stopGraph.cellsCount()};
+
+    if(sourceCellId >= cellsCount || gemCellId >= cellsCount || sourceCellId == gemCellId)
+        return {};
+
+    m_gemRowIndex = gemCellId / m_stopGraph.columnsCount();
+    m_gemColumnIndex = gemCellId % m_stopGraph.columnsCount();
+    m_expandedNodesCount = 0;
+
+    std::optional<BudgetResource> budgetResource;
+    std::optional<std::pmr::monotonic_buffer_resource> budgetArena;
+    std::optional<ScratchArena> scratchArena;
+    std::pmr::memory_resource* arena{};
+
+    if(m_budget.memoryBytes)
+    {
+        budgetResource.emplace(m_budget.memoryBytes.value());
+        budgetArena.emplace(std::clamp(m_budget.memoryBytes.value(), std::size_t{1}, kBudgetArenaChunkSize), &budgetResource.value());
+        arena = &budgetArena.value();
+    }
+
+    else
+    {
+        scratchArena.emplace();
+        arena = scratchArena->resource();
+    }
+
+    const auto deadline {m_budget.time ? std::optional{std::chrono::steady_clock::now() + m_budget.time.value()}
+                                       : std::nullopt};
+
+    std::pmr::vector<Node> nodes {arena};
+    std::pmr::vector<OpenEntry> open {arena};
+    std::pmr::unordered_map<quint32, quint32> bestCosts {arena};
+    std::pmr::unordered_map<quint32, quint8> gemCoveringSlides {arena};
+
+    quint32 bestLength {kUnreachable};
+    qint32 goalParent {-1};
+    qint8 goalDirectionIndex {-1};
+    qint32 bestPartialNode {-1};
+    bool exhausted {false};
+
+    try
+    {
+        for(const auto& coverer : m_stopGraph.coverers(gemCellId))
+            if(!m_blockedStops[m_stopGraph.slide(coverer.sourceCellId, coverer.directionIndex).destination])
+                gemCoveringSlides[coverer.sourceCellId] |= 1 << coverer.directionIndex;
+
+        nodes.push_back({sourceCellId, 0, -1, -1});
+        bestCosts[sourceCellId] = 0;
+        open.push_back({remainingMovesEstimate(sourceCellId), proximity(sourceCellId), 0});
+
+        while(open.size())
+        {
+            if(deadline && !(m_expandedNodesCount % kDeadlineCheckInterval) &&
+                std::chrono::steady_clock::now() >= deadline.value())
+            {
+                exhausted = true;
+                break;
+            }
+
+            std::pop_heap(open.begin(), open.end());
+            const auto entry {open.back()};
+            open.pop_back();
+
+            const auto node {nodes[entry.nodeIndex]};
+
+            if(entry.estimate >= bestLength)
+                break;
+
+            if(node.cost > bestCosts[node.cellId])
+                continue;
+
+            ++m_expandedNodesCount;
+
+            const auto coveringSlides {gemCoveringSlides.contains(node.cellId) ? gemCoveringSlides[node.cellId] : quint8{}};
+
+            for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+            {
+                if(!m_stopGraph.isMove(node.cellId, dirIndex))
+                    continue;
+
+                const auto destination {m_stopGraph.slide(node.cellId, dirIndex).destination};
+
+                if(m_blockedStops[destination])
+                    continue;
+
+                const auto cost {node.cost + 1};
+
+                if(coveringSlides & (1 << dirIndex))
+                {
+                    if(cost < bestLength)
+                    {
+                        bestLength = cost;
+                        goalParent = entry.nodeIndex;
+                        goalDirectionIndex = dirIndex;
+                    }
+
+                    continue;
+                }
+
+                if(cost >= bestLength)
+                    continue;
+
+                if(const auto it {bestCosts.find(destination)}; it != bestCosts.end() && it->second <= cost)
+                    continue;
+
+                nodes.push_back({destination, cost, static_cast<qint32>(entry.nodeIndex), static_cast<qint8>(dirIndex)});
+                bestCosts[destination] = cost;
+
+                const OpenEntry child {cost + remainingMovesEstimate(destination),
+                                       proximity(destination),
+                                       static_cast<quint32>(nodes.size() - 1)};
+
+                open.push_back(child);
+                std::push_heap(open.begin(), open.end());
+
+                if(bestPartialNode < 0 ||
+                    std::pair{child.estimate - cost, child.proximity} <
+                        std::pair{remainingMovesEstimate(nodes[bestPartialNode].cellId), proximity(nodes[bestPartialNode].cellId)})
+                    bestPartialNode = child.nodeIndex;
+            }
+        }
+    }
+
+    catch(const std::bad_alloc&)
+    {
+        exhausted = true;
+    }
+
+    if(bestLength != kUnreachable)
+    {
+        auto trace {tracePath(nodes, goalParent)};
+        trace.push_back(Constants::kAllDirections[goalDirectionIndex]);
+
+        return HintSearchResult{std::move(trace), !exhausted};
+    }
+
+    if(!exhausted)
+        return {};
+
+    if(bestPartialNode < 0)
+        return bestFirstMove(sourceCellId);
+
+    return HintSearchResult{{tracePath(nodes, bestPartialNode).front()}, false};
+}
+
+quint64 AnytimeHintSearch::expandedNodesCount() const
+{
+    return m_expandedNodesCount;
+}
+
+quint32 AnytimeHintSearch::remainingMovesEstimate(quint32 cellId) const
+{
+    const auto rowIndex {cellId / m_stopGraph.columnsCount()};
+    const auto columnIndex {cellId % m_stopGraph.columnsCount()};
+    const auto rowsDistance {rowIndex > m_gemRowIndex ? rowIndex - m_gemRowIndex : m_gemRowIndex - rowIndex};
+    const auto columnsDistance {columnIndex > m_gemColumnIndex ? columnIndex - m_gemColumnIndex : m_gemColumnIndex - columnIndex};
+
+    if(!rowsDistance || !columnsDistance || rowsDistance == columnsDistance)
+        return 1;
+
+    return 2;
+}
+
+std::optional<HintSearchResult> AnytimeHintSearch::bestFirstMove(quint32 sourceCellId) const
+{
+    std::optional<std::size_t> bestDirIndex;
+    std::pair<quint32, quint32> bestScore;
+
+    for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+    {
+        if(!m_stopGraph.isMove(sourceCellId, dirIndex))
+            continue;
+
+        const auto destination {m_stopGraph.slide(sourceCellId, dirIndex).destination};
+
+        if(m_blockedStops[destination])
+            continue;
+
+        const std::pair score {remainingMovesEstimate(destination), proximity(destination)};
+
+        if(!bestDirIndex || score < bestScore)
+        {
+            bestDirIndex = dirIndex;
+            bestScore = score;
+        }
+    }
+
+    if(!bestDirIndex)
+        return {};
+
+    return HintSearchResult{{Constants::kAllDirections[bestDirIndex.value()]}, false};
+}
+
+quint32 AnytimeHintSearch::proximity(quint32 cellId) const
+{
+    const auto rowIndex {cellId / m_stopGraph.columnsCount()};
+    const auto columnIndex {cellId % m_stopGraph.columnsCount()};
+    const auto rowsDistance {rowIndex > m_gemRowIndex ? rowIndex - m_gemRowIndex : m_gemRowIndex - rowIndex};
+    const auto columnsDistance {columnIndex > m_gemColumnIndex ? columnIndex - m_gemColumnIndex : m_gemColumnIndex - columnIndex};
+
+    return std::max(rowsDistance, columnsDistance);
+}
+
+std::vector<Definitions::MovementDirection> AnytimeHintSearch::tracePath(std::span<const Node> nodes, qint32 nodeIndex) const
+{
+    std::vector<Definitions::MovementDirection> result;
+
+    for(; nodes[nodeIndex].parent >= 0; nodeIndex = nodes[nodeIndex].parent)
+        result.push_back(Constants::kAllDirections[nodes[nodeIndex].directionIndex]);
+
+    std::reverse(result.begin(), result.end());
+
+    return result;
+}
+
+AnytimeHintSearch::BudgetResource::BudgetResource(std::size_t budgetBytes) : m_remainingBytes(budgetBytes)
+{
+
+}
+
+void* AnytimeHintSearch::BudgetResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if(bytes > m_remainingBytes)
+        throw std::bad_alloc{};
+
+    auto pointer {std::pmr::new_delete_resource()->allocate(bytes, alignment)};
+    m_remainingBytes -= bytes;
+
+    return pointer;
+}
+
+void AnytimeHintSearch::BudgetResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    m_remainingBytes += bytes;
+}
+
+bool AnytimeHintSearch::BudgetResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+bool AnytimeHintSearch::OpenEntry::operator<(const OpenEntry& other) const
+{
+    return std::tie(estimate, proximity) > std::tie(other.estimate, other.proximity);
+}
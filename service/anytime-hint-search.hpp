@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <chrono>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <vector>
+
+
+class StopGraph;
+
+
+struct HintBudget
+{
+    std::optional<std::chrono::milliseconds> time{};
+    std::optional<std::size_t> memoryBytes{};
+};
+
+
+struct HintSearchResult
+{
+    std::vector<Definitions::MovementDirection> trace;
+    bool optimal {true};
+};
+
+
+class AnytimeHintSearch
+{
+public:
+
+    AnytimeHintSearch(const StopGraph& stopGraph,
+                       const std::vector<bool>& blockedStops,
+                       const HintBudget& budget);
+
+    std::optional<HintSearchResult> search(quint32 sourceCellId, quint32 gemCellId);
+    quint64 expandedNodesCount() const;
+
+private:
+
+    struct Node
+    {
+        quint32 cellId{};
+        quint32 cost{};
+        qint32 parent{};
+        qint8 directionIndex{};
+    };
+
+    struct OpenEntry
+    {
+        quint32 estimate{};
+        quint32 proximity{};
+        quint32 nodeIndex{};
+
+        bool operator<(const OpenEntry& other) const;
+    };
+
+    class BudgetResource : public std::pmr::memory_resource
+    {
+    public:
+
+        explicit BudgetResource(std::size_t budgetBytes);
+
+    private:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        std::size_t m_remainingBytes{};
+    };
+
+    quint32 remainingMovesEstimate(quint32 cellId) const;
+    std::optional<HintSearchResult> bestFirstMove(quint32 sourceCellId) const;
+    quint32 proximity(quint32 cellId) const;
+    std::vector<Definitions::MovementDirection> tracePath(std::span<const Node> nodes, qint32 nodeIndex) const;
+
+    static inline constexpr quint32 kUnreachable = std::numeric_limits<quint32>::max();
+    static inline constexpr quint32 kDeadlineCheckInterval = 64;
+    static inline constexpr std::size_t kBudgetArenaChunkSize = 4 * 1024;
+
+    const StopGraph& m_stopGraph;
+    const std::vector<bool>& m_blockedStops;
+    HintBudget m_budget;
+
+    quint32 m_gemRowIndex{}, m_gemColumnIndex{};
+    quint64 m_expandedNodesCount{};
+};
@@ -0,0 +1,162 @@
+#include "bidirectional-hint-search.hpp"
+#include "stop-graph.hpp"
+#include "constants.hpp"
+
+#include <algorithm>
+
+
+BidirectionalHintSearch::BidirectionalHintSearch(const StopGraph& stopGraph,
+                                                 const std::vector<bool>& blockedStops) :
+    m_stopGraph(stopGraph),
+    m_blockedStops(blockedStops)
+{
+
+}
+
+std::optional<std::vector<Definitions::MovementDirection>>
+BidirectionalHintSearch::search(quint32 sourceCellId, quint32 gemCellId)
+{
+    const auto cellsCount {m_stopGraph.cellsCount()};
+
+    if(sourceCellId >= cellsCount || gemCellId >= cellsCount)
+        return {};
+
+    m_forwardDistances.assign(cellsCount, kUnreachable);
+    m_forwardParents.assign(cellsCount, 0);
+    m_forwardDirections.assign(cellsCount, -1);
+    m_backwardDistances.assign(cellsCount, kUnreachable);
+    m_backwardNexts.assign(cellsCount, 0);
+    m_backwardDirections.assign(cellsCount, -1);
+    m_forwardFrontier.clear();
+    m_backwardFrontier.clear();
+
+    m_sourceCellId = sourceCellId;
+    m_bestLength = kUnreachable;
+    m_expandedNodesCount = 0;
+
+    m_forwardDistances[sourceCellId] = 0;
+    m_forwardFrontier.push_back(sourceCellId);
+
+    for(const auto& coverer : m_stopGraph.coverers(gemCellId))
+    {
+        const auto cellId {coverer.sourceCellId};
+
+        if(m_backwardDistances[cellId] != kUnreachable ||
+            m_blockedStops[m_stopGraph.slide(cellId, coverer.directionIndex).destination])
+            continue;
+
+        m_backwardDistances[cellId] = 1;
+        m_backwardDirections[cellId] = coverer.directionIndex;
+        m_backwardFrontier.push_back(cellId);
+        checkMeeting(cellId);
+    }
+
+    while(m_bestLength == kUnreachable && m_forwardFrontier.size() && m_backwardFrontier.size())
+    {
+        if(m_forwardFrontier.size() <= m_backwardFrontier.size())
+            expandForward();
+
+        else
+            expandBackward();
+    }
+
+    if(m_bestLength == kUnreachable)
+        return {};
+
+    return tracePath();
+}
+
+quint64 BidirectionalHintSearch::expandedNodesCount() const
+{
+    return m_expandedNodesCount;
+}
+
+void BidirectionalHintSearch::expandForward()
+{
+    m_nextFrontier.clear();
+
+    for(const auto cellId : m_forwardFrontier)
+    {
+        ++m_expandedNodesCount;
+
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+        {
+            if(!m_stopGraph.isMove(cellId, dirIndex))
+                continue;
+
+            const auto destination {m_stopGraph.slide(cellId, dirIndex).destination};
+
+            if(m_blockedStops[destination] || m_forwardDistances[destination] != kUnreachable)
+                continue;
+
+            m_forwardDistances[destination] = m_forwardDistances[cellId] + 1;
+            m_forwardParents[destination] = cellId;
+            m_forwardDirections[destination] = dirIndex;
+            m_nextFrontier.push_back(destination);
+            checkMeeting(destination);
+        }
+    }
+
+    m_forwardFrontier.swap(m_nextFrontier);
+}
+
+void BidirectionalHintSearch::expandBackward()
+{
+    m_nextFrontier.clear();
+
+    for(const auto cellId : m_backwardFrontier)
+    {
+        ++m_expandedNodesCount;
+
+        if(m_blockedStops[cellId])
+            continue;
+
+        for(const auto& arrival : m_stopGraph.arrivals(cellId))
+        {
+            const auto predecessor {arrival.sourceCellId};
+
+            if(m_backwardDistances[predecessor] != kUnreachable)
+                continue;
+
+            m_backwardDistances[predecessor] = m_backwardDistances[cellId] + 1;
+            m_backwardNexts[predecessor] = cellId;
+            m_backwardDirections[predecessor] = arrival.directionIndex;
+            m_nextFrontier.push_back(predecessor);
+            checkMeeting(predecessor);
+        }
+    }
+
+    m_backwardFrontier.swap(m_nextFrontier);
+}
+
+void BidirectionalHintSearch::checkMeeting(quint32 cellId)
+{
+    if(m_forwardDistances[cellId] == kUnreachable || m_backwardDistances[cellId] == kUnreachable)
+        return;
+
+    if(const auto length {m_forwardDistances[cellId] + m_backwardDistances[cellId]}; length < m_bestLength)
+    {
+        m_bestLength = length;
+        m_meetingCellId = cellId;
+    }
+}
+
+std::vector<Definitions::MovementDirection> BidirectionalHintSearch::tracePath() const
+{
+    std::vector<Definitions::MovementDirection> result;
+
+    for(auto cellId {m_meetingCellId}; cellId != m_sourceCellId; cellId = m_forwardParents[cellId])
+        result.push_back(Constants::kAllDirections[m_forwardDirections[cellId]]);
+
+    std::reverse(result.begin(), result.end());
+
+    for(auto cellId {m_meetingCellId}; ; cellId = m_backwardNexts[cellId])
+    {
+        result.push_back(Constants::kAllDirections[m_backwardDirections[cellId]]);
+
+        if(m_backwardDistances[cellId] == 1)
+            break;
+    }
+
+    return result;
+}
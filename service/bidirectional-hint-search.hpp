@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <optional>
+#include <vector>
+
+
+class StopGraph;
+
+
+class BidirectionalHintSearch
+{
+public:
+
+    BidirectionalHintSearch(const StopGraph& stopGraph, const std::vector<bool>& blockedStops);
+
+    std::optional<std::vector<Definitions::MovementDirection>> search(quint32 sourceCellId, quint32 gemCellId);
+    quint64 expandedNodesCount() const;
+
+private:
+
+    void expandForward();
+    void expandBackward();
+    void checkMeeting(quint32 cellId);
+    std::vector<Definitions::MovementDirection> tracePath() const;
+
+    static inline constexpr quint32 kUnreachable = std::numeric_limits<quint32>::max();
+
+    const StopGraph& m_stopGraph;
+    const std::vector<bool>& m_blockedStops;
+
+    std::vector<quint32> m_forwardDistances, m_forwardParents;
+    std::vector<quint32> m_backwardDistances, m_backwardNexts;
+    std::vector<qint8> m_forwardDirections, m_backwardDirections;
+    std::vector<quint32> m_forwardFrontier, m_backwardFrontier, m_nextFrontier;
+
+    quint32 m_sourceCellId{};
+    quint32 m_bestLength {kUnreachable};
+    quint32 m_meetingCellId{};
+    quint64 m_expandedNodesCount{};
+};
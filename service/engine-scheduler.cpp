@@ -0,0 +1,221 @@
+#include "engine-scheduler.hpp"
+#include "engine-trace.hpp"
+#include "engine-stats.hpp"
+
+#include <algorithm>
+
+
+EngineScheduler& EngineScheduler::instance()
+{
+    static EngineScheduler instance;
+    return instance;
+}
+
+EngineScheduler::EngineScheduler() :
+    m_threadBudget(std::clamp<std::size_t>(QThread::idealThreadCount(), kMinThreadBudget, kMaxThreadBudget))
+{
+
+}
+
+EngineScheduler::~EngineScheduler()
+{
+    {
+        std::scoped_lock lock{m_mutex};
+        m_stopping = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    for(std::size_t workerIndex{}; workerIndex < m_startedWorkersCount; ++workerIndex)
+    {
+        m_workers[workerIndex].thread->wait();
+        delete m_workers[workerIndex].thread;
+    }
+}
+
+void EngineScheduler::submit(TaskPriority priority, std::function<void()> task)
+{
+    const auto priorityIndex {static_cast<std::size_t>(priority)};
+
+    {
+        std::scoped_lock lock{m_mutex};
+
+        startWorkers();
+
+        auto workerIndex {t_workerIndex.value_or(m_threadBudget)};
+
+        if(workerIndex >= m_threadBudget)
+            workerIndex = m_nextWorkerIndex++ % m_threadBudget;
+
+        {
+            std::scoped_lock workerLock{m_workers[workerIndex].mutex};
+            m_workers[workerIndex].tasks[priorityIndex].push_back(std::move(task));
+        }
+
+        ++m_pendingCounts[priorityIndex];
+    }
+
+    m_wakeUp.notify_all();
+}
+
+void EngineScheduler::setThreadBudget(std::size_t threadBudget)
+{
+    {
+        std::scoped_lock lock{m_mutex};
+
+        m_threadBudget = std::clamp<std::size_t>(threadBudget, kMinThreadBudget, kMaxThreadBudget);
+
+        if(m_startedWorkersCount)
+            startWorkers();
+    }
+
+    m_wakeUp.notify_all();
+}
+
+std::size_t EngineScheduler::threadBudget() const
+{
+    std::scoped_lock lock{m_mutex};
+    return m_threadBudget;
+}
+
+void EngineScheduler::run(std::size_t workerIndex)
+{
+    t_workerIndex = workerIndex;
+
+    std::unique_lock lock{m_mutex};
+
+    while(true)
+    {
+        std::optional<TaskPriority> priority;
+
+        m_wakeUp.wait(lock, [this, workerIndex, &priority]
+        {
+            if(m_stopping)
+                return true;
+
+            if(workerIndex < m_threadBudget)
+                priority = runnablePriority();
+
+            return priority.has_value();
+        });
+
+        if(m_stopping)
+            return;
+
+        const auto priorityIndex {static_cast<std::size_t>(priority.value())};
+
+        --m_pendingCounts[priorityIndex];
+        ++m_runningCounts[priorityIndex];
+        lock.unlock();
+
+        auto task {takeTask(workerIndex, priority.value())};
+        QThread::currentThread()->setPriority(threadPriority(priority.value()));
+
+        try
+        {
+            INERTIA_TRACE_SCOPE(taskTraceName(priority.value()));
+            task();
+        }
+
+        catch(...)
+        {
+            INERTIA_STATS_COUNT(TasksFailed);
+        }
+
+        lock.lock();
+        --m_runningCounts[priorityIndex];
+        m_wakeUp.notify_all();
+    }
+}
+
+void EngineScheduler::startWorkers()
+{
+    for(; m_startedWorkersCount < m_threadBudget; ++m_startedWorkersCount)
+    {
+        auto& worker {m_workers[m_startedWorkersCount]};
+        worker.thread = QThread::create(&EngineScheduler::run, this, m_startedWorkersCount);
+        worker.thread->setObjectName(QString("Engine worker %1").arg(m_startedWorkersCount));
+        worker.thread->start();
+    }
+}
+
+std::optional<TaskPriority> EngineScheduler::runnablePriority() const
+{
+    const auto interactiveIndex {static_cast<std::size_t>(TaskPriority::Interactive)};
+    const auto loadIndex {static_cast<std::size_t>(TaskPriority::Load)};
+    const auto backgroundIndex {static_cast<std::size_t>(TaskPriority::Background)};
+
+    const auto deferrableLimit {m_threadBudget - 1};
+    const auto backgroundLimit {m_threadBudget > 2 ? m_threadBudget - 2 : 1};
+    const auto runningDeferrableCount {m_runningCounts[loadIndex] + m_runningCounts[backgroundIndex]};
+
+    if(m_pendingCounts[interactiveIndex])
+        return TaskPriority::Interactive;
+
+    if(runningDeferrableCount >= deferrableLimit)
+        return {};
+
+    if(m_pendingCounts[loadIndex])
+        return TaskPriority::Load;
+
+    if(m_pendingCounts[backgroundIndex] && m_runningCounts[backgroundIndex] < backgroundLimit)
+        return TaskPriority::Background;
+
+    return {};
+}
+
+std::function<void()> EngineScheduler::takeTask(std::size_t workerIndex, TaskPriority priority)
+{
+    const auto priorityIndex {static_cast<std::size_t>(priority)};
+
+    while(true)
+        for(std::size_t offset{}; offset < kMaxThreadBudget; ++offset)
+        {
+            auto& worker {m_workers[(workerIndex + offset) % kMaxThreadBudget]};
+            std::scoped_lock lock{worker.mutex};
+            auto& tasks {worker.tasks[priorityIndex]};
+
+            if(tasks.empty())
+                continue;
+
+            auto task {offset ? std::move(tasks.front()) : std::move(tasks.back())};
+
+            if(offset)
+                tasks.pop_front();
+
+            else
+                tasks.pop_back();
+
+            return task;
+        }
+}
+
+const char* EngineScheduler::taskTraceName(TaskPriority priority)
+{
+    switch(priority)
+    {
+    case TaskPriority::Interactive:
+        return "interactiveTask";
+
+    case TaskPriority::Load:
+        return "loadTask";
+
+    default:
+        return "backgroundTask";
+    }
+}
+
+QThread::Priority EngineScheduler::threadPriority(TaskPriority priority)
+{
+    switch(priority)
+    {
+    case TaskPriority::Interactive:
+        return QThread::HighestPriority;
+
+    case TaskPriority::Load:
+        return QThread::HighPriority;
+
+    default:
+        return QThread::LowPriority;
+    }
+}
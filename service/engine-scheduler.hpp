@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QThread>
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+
+enum class TaskPriority
+{
+    Interactive,
+    Load,
+    Background
+};
+
+
+class EngineScheduler
+{
+public:
+
+    static EngineScheduler& instance();
+
+    EngineScheduler(const EngineScheduler&) = delete;
+    EngineScheduler& operator=(const EngineScheduler&) = delete;
+    ~EngineScheduler();
+
+    void submit(TaskPriority priority, std::function<void()> task);
+    void setThreadBudget(std::size_t threadBudget);
+    std::size_t threadBudget() const;
+
+    static inline constexpr std::size_t kMinThreadBudget {2};
+    static inline constexpr std::size_t kMaxThreadBudget {64};
+
+private:
+
+    static inline constexpr std::size_t kPrioritiesCount {3};
+
+    struct Worker
+    {
+        std::array<std::deque<std::function<void()>>, kPrioritiesCount> tasks;
+        std::mutex mutex;
+        QThread* thread{};
+    };
+
+    EngineScheduler();
+
+    void run(std::size_t workerIndex);
+    void startWorkers();
+    std::optional<TaskPriority> runnablePriority() const;
+    std::function<void()> takeTask(std::size_t workerIndex, TaskPriority priority);
+    static QThread::Priority threadPriority(TaskPriority priority);
+    static const char* taskTraceName(TaskPriority priority);
+
+    std::array<Worker, kMaxThreadBudget> m_workers;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::array<std::size_t, kPrioritiesCount> m_pendingCounts{};
+    std::array<std::size_t, kPrioritiesCount> m_runningCounts{};
+    std::size_t m_threadBudget{};
+    std::size_t m_startedWorkersCount{};
+    std::size_t m_nextWorkerIndex{};
+    bool m_stopping{false};
+
+    static inline thread_local std::optional<std::size_t> t_workerIndex{};
+};
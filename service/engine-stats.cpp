@@ -0,0 +1,175 @@
+#include "engine-stats.hpp"
+
+
+EngineStatsSnapshot& EngineStatsSnapshot::operator+=(const EngineStatsSnapshot& other)
+{
+    for(std::size_t i{}; i < kCountersCount; ++i)
+        counters[i] += other.counters[i];
+
+    for(std::size_t i{}; i < kTimersCount; ++i)
+    {
+        timerCounts[i] += other.timerCounts[i];
+        timerNanoseconds[i] += other.timerNanoseconds[i];
+    }
+
+    return *this;
+}
+
+EngineStatsSnapshot& EngineStatsSnapshot::operator-=(const EngineStatsSnapshot& other)
+{
+    for(std::size_t i{}; i < kCountersCount; ++i)
+        counters[i] -= other.counters[i];
+
+    for(std::size_t i{}; i < kTimersCount; ++i)
+    {
+        timerCounts[i] -= other.timerCounts[i];
+        timerNanoseconds[i] -= other.timerNanoseconds[i];
+    }
+
+    return *this;
+}
+
+EngineStats& EngineStats::instance()
+{
+    static EngineStats instance;
+    return instance;
+}
+
+EngineStatsSnapshot EngineStats::snapshot() const
+{
+    std::scoped_lock lock{m_mutex};
+
+    auto result {m_retiredThreads};
+
+    for(const auto threadCounters : m_liveThreads)
+        result += threadCounters->load();
+
+    result -= m_baseline;
+
+    return result;
+}
+
+void EngineStats::reset()
+{
+    auto baseline {snapshot()};
+
+    std::scoped_lock lock{m_mutex};
+    m_baseline += baseline;
+}
+
+void EngineStats::add(StatCounter counter, quint64 amount)
+{
+    increase(threadCounters().counters[static_cast<std::size_t>(counter)], amount);
+}
+
+void EngineStats::record(StatTimer timer, std::chrono::steady_clock::duration elapsed)
+{
+    auto& threadCounters {EngineStats::threadCounters()};
+    const auto timerIndex {static_cast<std::size_t>(timer)};
+
+    increase(threadCounters.timerCounts[timerIndex], 1);
+    increase(threadCounters.timerNanoseconds[timerIndex],
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+std::string_view EngineStats::counterName(StatCounter counter)
+{
+    switch(counter)
+    {
+    case StatCounter::StopPatternsTried:
+        return "stopPatternsTried";
+    case StatCounter::PatternsRejectedUnreachableGem:
+        return "patternsRejectedUnreachableGem";
+    case StatCounter::PatternsRejectedUnsolvable:
+        return "patternsRejectedUnsolvable";
+    case StatCounter::GamesGenerated:
+        return "gamesGenerated";
+    case StatCounter::HintExpansions:
+        return "hintExpansions";
+    case StatCounter::PackEntriesRead:
+        return "packEntriesRead";
+    case StatCounter::PackEntriesWritten:
+        return "packEntriesWritten";
+    case StatCounter::TasksFailed:
+        return "tasksFailed";
+    default:
+        return {};
+    }
+}
+
+std::string_view EngineStats::timerName(StatTimer timer)
+{
+    switch(timer)
+    {
+    case StatTimer::Layout:
+        return "layout";
+    case StatTimer::StopPatterns:
+        return "stopPatterns";
+    case StatTimer::SolvabilityCheck:
+        return "solvabilityCheck";
+    case StatTimer::HintSearch:
+        return "hintSearch";
+    case StatTimer::PackRead:
+        return "packRead";
+    case StatTimer::PackWrite:
+        return "packWrite";
+    default:
+        return {};
+    }
+}
+
+EngineStats::ThreadCounters& EngineStats::threadCounters()
+{
+    static thread_local ThreadCounters threadCounters;
+    return threadCounters;
+}
+
+void EngineStats::increase(std::atomic<quint64>& value, quint64 amount)
+{
+    // Only the owning thread writes its counters, so a relaxed load and store avoids a locked read-modify-write
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+EngineStats::ThreadCounters::ThreadCounters()
+{
+    auto& stats {EngineStats::instance()};
+
+    std::scoped_lock lock{stats.m_mutex};
+    stats.m_liveThreads.push_back(this);
+}
+
+EngineStats::ThreadCounters::~ThreadCounters()
+{
+    auto& stats {EngineStats::instance()};
+
+    std::scoped_lock lock{stats.m_mutex};
+    stats.m_retiredThreads += load();
+    std::erase(stats.m_liveThreads, this);
+}
+
+EngineStatsSnapshot EngineStats::ThreadCounters::load() const
+{
+    EngineStatsSnapshot result;
+
+    for(std::size_t i{}; i < EngineStatsSnapshot::kCountersCount; ++i)
+        result.counters[i] = counters[i].load(std::memory_order_relaxed);
+
+    for(std::size_t i{}; i < EngineStatsSnapshot::kTimersCount; ++i)
+    {
+        result.timerCounts[i] = timerCounts[i].load(std::memory_order_relaxed);
+        result.timerNanoseconds[i] = timerNanoseconds[i].load(std::memory_order_relaxed);
+    }
+
+    return result;
+}
+
+EngineStats::ScopedTimer::ScopedTimer(StatTimer timer) : m_timer(timer),
+                                                          m_start(std::chrono::steady_clock::now())
+{
+
+}
+
+EngineStats::ScopedTimer::~ScopedTimer()
+{
+    EngineStats::record(m_timer, std::chrono::steady_clock::now() - m_start);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+
+#ifdef INERTIA_ENABLE_STATS
+#define INERTIA_STATS_COUNT(counter) EngineStats::add(StatCounter::counter, 1)
+#define INERTIA_STATS_ADD(counter, amount) EngineStats::add(StatCounter::counter, amount)
+#define INERTIA_STATS_SCOPE(timer) const EngineStats::ScopedTimer statsScopedTimer {StatTimer::timer}
+#else
+#define INERTIA_STATS_COUNT(counter) static_cast<void>(0)
+#define INERTIA_STATS_ADD(counter, amount) static_cast<void>(0)
+#define INERTIA_STATS_SCOPE(timer)
+#endif
+
+
+enum class StatCounter
+{
+    StopPatternsTried,
+    PatternsRejectedUnreachableGem,
+    PatternsRejectedUnsolvable,
+    GamesGenerated,
+    HintExpansions,
+    PackEntriesRead,
+    PackEntriesWritten,
+    TasksFailed,
+    Count
+};
+
+enum class StatTimer
+{
+    Layout,
+    StopPatterns,
+    SolvabilityCheck,
+    HintSearch,
+    PackRead,
+    PackWrite,
+    Count
+};
+
+
+struct EngineStatsSnapshot
+{
+    static inline constexpr std::size_t kCountersCount {static_cast<std::size_t>(StatCounter::Count)};
+    static inline constexpr std::size_t kTimersCount {static_cast<std::size_t>(StatTimer::Count)};
+
+    std::array<quint64, kCountersCount> counters{};
+    std::array<quint64, kTimersCount> timerCounts{};
+    std::array<quint64, kTimersCount> timerNanoseconds{};
+
+    EngineStatsSnapshot& operator+=(const EngineStatsSnapshot& other);
+    EngineStatsSnapshot& operator-=(const EngineStatsSnapshot& other);
+};
+
+
+class EngineStats
+{
+public:
+
+    static EngineStats& instance();
+
+    EngineStats(const EngineStats&) = delete;
+    EngineStats& operator=(const EngineStats&) = delete;
+
+    EngineStatsSnapshot snapshot() const;
+    void reset();
+
+    static void add(StatCounter counter, quint64 amount);
+    static void record(StatTimer timer, std::chrono::steady_clock::duration elapsed);
+
+    static std::string_view counterName(StatCounter counter);
+    static std::string_view timerName(StatTimer timer);
+
+#ifdef INERTIA_ENABLE_STATS
+    static inline constexpr bool kEnabled {true};
+#else
+    static inline constexpr bool kEnabled {false};
+#endif
+
+    class ScopedTimer
+    {
+    public:
+
+        explicit ScopedTimer(StatTimer timer);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+
+        StatTimer m_timer;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+private:
+
+    struct ThreadCounters
+    {
+        ThreadCounters();
+        ~ThreadCounters();
+
+        EngineStatsSnapshot load() const;
+
+        std::array<std::atomic<quint64>, EngineStatsSnapshot::kCountersCount> counters{};
+        std::array<std::atomic<quint64>, EngineStatsSnapshot::kTimersCount> timerCounts{};
+        std::array<std::atomic<quint64>, EngineStatsSnapshot::kTimersCount> timerNanoseconds{};
+    };
+
+    EngineStats() = default;
+
+    static ThreadCounters& threadCounters();
+    static void increase(std::atomic<quint64>& value, quint64 amount);
+
+    mutable std::mutex m_mutex;
+    std::vector<const ThreadCounters*> m_liveThreads;
+    EngineStatsSnapshot m_retiredThreads;
+    EngineStatsSnapshot m_baseline;
+};
@@ -0,0 +1,148 @@
+#include "engine-trace.hpp"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <format>
+
+
+EngineTrace& EngineTrace::instance()
+{
+    static EngineTrace instance;
+    return instance;
+}
+
+void EngineTrace::start()
+{
+    std::scoped_lock lock{m_mutex};
+
+    for(const auto threadEvents : m_liveThreads)
+    {
+        std::scoped_lock threadLock{threadEvents->mutex};
+        threadEvents->events.clear();
+    }
+
+    m_retiredThreads.clear();
+    m_origin = Clock::now();
+    m_recording = true;
+}
+
+void EngineTrace::stop(const QString& filePath)
+{
+    m_recording = false;
+
+    std::vector<RetiredThread> threads;
+
+    {
+        std::scoped_lock lock{m_mutex};
+        threads = std::move(m_retiredThreads);
+        m_retiredThreads.clear();
+
+        for(const auto threadEvents : m_liveThreads)
+        {
+            std::scoped_lock threadLock{threadEvents->mutex};
+            threads.push_back({threadEvents->threadId, threadEvents->threadName, std::move(threadEvents->events)});
+            threadEvents->events.clear();
+        }
+    }
+
+    write(filePath, threads);
+}
+
+bool EngineTrace::isRecording() const
+{
+    return m_recording.load(std::memory_order_relaxed);
+}
+
+EngineTrace::ThreadEvents& EngineTrace::threadEvents()
+{
+    static thread_local ThreadEvents threadEvents;
+    return threadEvents;
+}
+
+void EngineTrace::record(const char* name, Clock::time_point start, Clock::duration duration)
+{
+    if(!isRecording())
+        return;
+
+    auto& threadEvents {EngineTrace::threadEvents()};
+
+    std::scoped_lock lock{threadEvents.mutex};
+    threadEvents.events.push_back({name, start, duration});
+}
+
+void EngineTrace::write(const QString& filePath, const std::vector<RetiredThread>& threads) const
+{
+    const auto processId {QCoreApplication::applicationPid()};
+    QJsonArray traceEvents;
+
+    for(const auto& [threadId, threadName, events] : threads)
+    {
+        if(events.empty())
+            continue;
+
+        traceEvents.append(QJsonObject{{"name", "thread_name"},
+                                       {"ph", "M"},
+                                       {"pid", processId},
+                                       {"tid", static_cast<qint64>(threadId)},
+                                       {"args", QJsonObject{{"name", threadName}}}});
+
+        for(const auto& [name, start, duration] : events)
+            traceEvents.append(QJsonObject{{"name", name},
+                                           {"cat", "engine"},
+                                           {"ph", "X"},
+                                           {"ts", std::chrono::duration<double, std::micro>(start - m_origin).count()},
+                                           {"dur", std::chrono::duration<double, std::micro>(duration).count()},
+                                           {"pid", processId},
+                                           {"tid", static_cast<qint64>(threadId)}});
+    }
+
+    QFile file{filePath};
+
+    if(!file.open(QIODevice::WriteOnly))
+        throw std::runtime_error{std::format("Could not open the file {} for writing the trace into", filePath.toStdString())};
+
+    file.write(QJsonDocument{QJsonObject{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}}}.toJson(QJsonDocument::Compact));
+}
+
+EngineTrace::ThreadEvents::ThreadEvents()
+{
+    auto& trace {EngineTrace::instance()};
+
+    std::scoped_lock lock{trace.m_mutex};
+    threadId = trace.m_nextThreadId++;
+    threadName = QThread::currentThread()->objectName();
+
+    if(threadName.isEmpty())
+        threadName = QString("Thread %1").arg(threadId);
+
+    trace.m_liveThreads.push_back(this);
+}
+
+EngineTrace::ThreadEvents::~ThreadEvents()
+{
+    auto& trace {EngineTrace::instance()};
+
+    std::scoped_lock lock{trace.m_mutex, mutex};
+
+    if(events.size())
+        trace.m_retiredThreads.push_back({threadId, threadName, std::move(events)});
+
+    std::erase(trace.m_liveThreads, this);
+}
+
+EngineTrace::Span::Span(const char* name) : m_name(name)
+{
+    if(EngineTrace::instance().isRecording())
+        m_start = Clock::now();
+}
+
+EngineTrace::Span::~Span()
+{
+    if(m_start)
+        EngineTrace::instance().record(m_name, m_start.value(), Clock::now() - m_start.value());
+}
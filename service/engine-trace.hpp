@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+#ifdef INERTIA_ENABLE_TRACE
+#define INERTIA_TRACE_SCOPE(name) const EngineTrace::Span traceSpan {name}
+#else
+#define INERTIA_TRACE_SCOPE(name)
+#endif
+
+
+class EngineTrace
+{
+public:
+
+    static EngineTrace& instance();
+
+    EngineTrace(const EngineTrace&) = delete;
+    EngineTrace& operator=(const EngineTrace&) = delete;
+
+    void start();
+    void stop(const QString& filePath);
+    bool isRecording() const;
+
+#ifdef INERTIA_ENABLE_TRACE
+    static inline constexpr bool kEnabled {true};
+#else
+    static inline constexpr bool kEnabled {false};
+#endif
+
+    class Span
+    {
+    public:
+
+        explicit Span(const char* name);
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+
+        const char* m_name;
+        std::optional<std::chrono::steady_clock::time_point> m_start;
+    };
+
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        const char* name{};
+        Clock::time_point start;
+        Clock::duration duration{};
+    };
+
+    struct ThreadEvents
+    {
+        ThreadEvents();
+        ~ThreadEvents();
+
+        quint64 threadId{};
+        QString threadName;
+        std::mutex mutex;
+        std::vector<Event> events;
+    };
+
+    struct RetiredThread
+    {
+        quint64 threadId{};
+        QString threadName;
+        std::vector<Event> events;
+    };
+
+    EngineTrace() = default;
+
+    static ThreadEvents& threadEvents();
+    void record(const char* name, Clock::time_point start, Clock::duration duration);
+    void write(const QString& filePath, const std::vector<RetiredThread>& threads) const;
+
+    std::atomic<bool> m_recording{false};
+    Clock::time_point m_origin;
+    mutable std::mutex m_mutex;
+    std::vector<ThreadEvents*> m_liveThreads;
+    std::vector<RetiredThread> m_retiredThreads;
+    quint64 m_nextThreadId{1};
+};
@@ -0,0 +1,332 @@
+#include "gem-distance-field.hpp"
+#include "game-state-maintainer.hpp"
+#include "constants.hpp"
+
+
+void GemDistanceField::build(const GameStateMaintainer& state)
+{
+    build(state, state.boardVersion());
+}
+
+void GemDistanceField::build(const GameStateMaintainer& state, quint64 boardVersion)
+{
+    auto stopGraph {std::make_shared<StopGraph>()};
+    stopGraph->build(state);
+    m_stopGraph = std::move(stopGraph);
+
+    const auto cellsCount {m_stopGraph->cellsCount()};
+
+    m_remainingGems.assign(cellsCount, false);
+    m_stuckAreaGems.assign(cellsCount, false);
+    m_stuckAreaCells.assign(cellsCount, false);
+    m_affected.assign(cellsCount, false);
+
+    for(const auto& gemPos : state.gemsPositions())
+        m_remainingGems[state.cellId(gemPos)] = true;
+
+    for(const auto& gemPos : state.stuckAreaGems())
+        m_stuckAreaGems[state.cellId(gemPos)] = true;
+
+    for(const auto& pos : state.stuckArea())
+        m_stuckAreaCells[state.cellId(pos)] = true;
+
+    m_canEnterStuckArea = state.canEnterStuckArea();
+    m_boardVersion = boardVersion;
+
+    computeDistances();
+}
+
+bool GemDistanceField::isBuiltFor(quint64 boardVersion) const
+{
+    return m_boardVersion && m_boardVersion.value() == boardVersion;
+}
+
+void GemDistanceField::onGemPicked(const GameStateMaintainer& state, quint32 gemCellId)
+{
+    if(!m_remainingGems[gemCellId])
+        return;
+
+    const auto wasEligible {isEligibleGem(gemCellId)};
+    m_remainingGems[gemCellId] = false;
+
+    if(const auto canEnterStuckArea {state.canEnterStuckArea()}; canEnterStuckArea != m_canEnterStuckArea)
+    {
+        m_canEnterStuckArea = canEnterStuckArea;
+        computeDistances();
+    }
+
+    else if(wasEligible)
+        repairAffectedCells(gemCellId);
+}
+
+void GemDistanceField::onGemsRestored(const GameStateMaintainer& state, const std::vector<quint32>& gemCellIds)
+{
+    for(const auto gemCellId : gemCellIds)
+        m_remainingGems[gemCellId] = true;
+
+    if(const auto canEnterStuckArea {state.canEnterStuckArea()}; canEnterStuckArea != m_canEnterStuckArea)
+    {
+        m_canEnterStuckArea = canEnterStuckArea;
+        computeDistances();
+        return;
+    }
+
+    std::vector<quint32> queue;
+
+    for(const auto gemCellId : gemCellIds)
+    {
+        if(!isEligibleGem(gemCellId))
+            continue;
+
+        for(const auto& coverer : m_stopGraph->coverers(gemCellId))
+            if(m_distances[coverer.sourceCellId] > 1 &&
+                isAllowedStop(m_stopGraph->slide(coverer.sourceCellId, coverer.directionIndex).destination))
+            {
+                setEntry(coverer.sourceCellId, 1, coverer.directionIndex, gemCellId);
+                queue.push_back(coverer.sourceCellId);
+            }
+    }
+
+    for(std::size_t i{}; i < queue.size(); ++i)
+    {
+        const auto cellId {queue[i]};
+
+        if(!isAllowedStop(cellId))
+            continue;
+
+        for(const auto& arrival : m_stopGraph->arrivals(cellId))
+            if(m_distances[cellId] + 1 < m_distances[arrival.sourceCellId])
+            {
+                setEntry(arrival.sourceCellId, m_distances[cellId] + 1, arrival.directionIndex, m_targetGems[cellId]);
+                queue.push_back(arrival.sourceCellId);
+            }
+    }
+}
+
+void GemDistanceField::syncGems(const GameStateMaintainer& state)
+{
+    std::vector<quint32> restoredGemCellIds;
+
+    for(quint32 cellId{}; cellId < m_remainingGems.size(); ++cellId)
+    {
+        const auto isGem {state.gemIndex().contains(state.cellPosition(cellId))};
+
+        if(m_remainingGems[cellId] && !isGem)
+            onGemPicked(state, cellId);
+
+        else if(!m_remainingGems[cellId] && isGem)
+            restoredGemCellIds.push_back(cellId);
+    }
+
+    if(restoredGemCellIds.size())
+        onGemsRestored(state, restoredGemCellIds);
+}
+
+std::optional<quint32> GemDistanceField::distance(quint32 cellId) const
+{
+    if(cellId >= m_distances.size() || m_distances[cellId] == kUnreachable)
+        return {};
+
+    return m_distances[cellId];
+}
+
+std::optional<quint32> GemDistanceField::targetGem(quint32 cellId) const
+{
+    if(!distance(cellId))
+        return {};
+
+    return m_targetGems[cellId];
+}
+
+Definitions::MovementDirection GemDistanceField::firstDirection(quint32 cellId) const
+{
+    if(!distance(cellId))
+        return Definitions::MovementDirection::InvalidDirection;
+
+    return Constants::kAllDirections[m_firstDirections[cellId]];
+}
+
+std::vector<Definitions::MovementDirection> GemDistanceField::trace(quint32 cellId) const
+{
+    std::vector<Definitions::MovementDirection> result;
+
+    if(!distance(cellId))
+        return result;
+
+    for(auto currentCell {cellId}; ; currentCell = m_stopGraph->slide(currentCell, m_firstDirections[currentCell]).destination)
+    {
+        result.push_back(Constants::kAllDirections[m_firstDirections[currentCell]]);
+
+        if(m_distances[currentCell] == 1)
+            break;
+    }
+
+    return result;
+}
+
+std::shared_ptr<const StopGraph> GemDistanceField::stopGraph() const
+{
+    return m_stopGraph;
+}
+
+std::vector<bool> GemDistanceField::blockedStops() const
+{
+    if(m_canEnterStuckArea)
+        return std::vector<bool>(m_stuckAreaCells.size(), false);
+
+    return m_stuckAreaCells;
+}
+
+void GemDistanceField::computeDistances()
+{
+    const auto cellsCount {m_stopGraph->cellsCount()};
+
+    m_distances.assign(cellsCount, kUnreachable);
+    m_firstDirections.assign(cellsCount, -1);
+    m_targetGems.assign(cellsCount, kNoGem);
+
+    std::vector<quint32> queue;
+
+    for(quint32 cellId{}; cellId < cellsCount; ++cellId)
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+            if(const auto gemCellId {firstEligibleGem(cellId, dirIndex)})
+            {
+                setEntry(cellId, 1, dirIndex, gemCellId.value());
+                queue.push_back(cellId);
+                break;
+            }
+
+    for(std::size_t i{}; i < queue.size(); ++i)
+    {
+        const auto cellId {queue[i]};
+
+        if(!isAllowedStop(cellId))
+            continue;
+
+        for(const auto& arrival : m_stopGraph->arrivals(cellId))
+            if(m_distances[arrival.sourceCellId] == kUnreachable)
+            {
+                setEntry(arrival.sourceCellId, m_distances[cellId] + 1, arrival.directionIndex, m_targetGems[cellId]);
+                queue.push_back(arrival.sourceCellId);
+            }
+    }
+}
+
+void GemDistanceField::repairAffectedCells(quint32 gemCellId)
+{
+    std::vector<quint32> affectedCells;
+
+    for(const auto& coverer : m_stopGraph->coverers(gemCellId))
+        if(m_targetGems[coverer.sourceCellId] == static_cast<qint32>(gemCellId) && !m_affected[coverer.sourceCellId])
+        {
+            m_affected[coverer.sourceCellId] = true;
+            affectedCells.push_back(coverer.sourceCellId);
+        }
+
+    for(std::size_t i{}; i < affectedCells.size(); ++i)
+        for(const auto& arrival : m_stopGraph->arrivals(affectedCells[i]))
+            if(m_targetGems[arrival.sourceCellId] == static_cast<qint32>(gemCellId) &&
+                m_firstDirections[arrival.sourceCellId] == arrival.directionIndex &&
+                !m_affected[arrival.sourceCellId])
+            {
+                m_affected[arrival.sourceCellId] = true;
+                affectedCells.push_back(arrival.sourceCellId);
+            }
+
+    for(const auto cellId : affectedCells)
+    {
+        m_distances[cellId] = kUnreachable;
+        m_firstDirections[cellId] = -1;
+        m_targetGems[cellId] = kNoGem;
+    }
+
+    std::vector<std::vector<quint32>> buckets;
+
+    for(const auto cellId : affectedCells)
+    {
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+        {
+            if(const auto candidateGem {firstEligibleGem(cellId, dirIndex)})
+            {
+                setEntry(cellId, 1, dirIndex, candidateGem.value());
+                break;
+            }
+
+            if(!m_stopGraph->isMove(cellId, dirIndex))
+                continue;
+
+            const auto destination {m_stopGraph->slide(cellId, dirIndex).destination};
+
+            if(m_affected[destination] || m_distances[destination] == kUnreachable || !isAllowedStop(destination))
+                continue;
+
+            if(m_distances[destination] + 1 < m_distances[cellId])
+                setEntry(cellId, m_distances[destination] + 1, dirIndex, m_targetGems[destination]);
+        }
+
+        if(m_distances[cellId] != kUnreachable)
+        {
+            if(buckets.size() <= m_distances[cellId])
+                buckets.resize(m_distances[cellId] + 1);
+
+            buckets[m_distances[cellId]].push_back(cellId);
+        }
+    }
+
+    for(std::size_t distance{1}; distance < buckets.size(); ++distance)
+        for(std::size_t i{}; i < buckets[distance].size(); ++i)
+        {
+            const auto cellId {buckets[distance][i]};
+
+            if(m_distances[cellId] != distance || !isAllowedStop(cellId))
+                continue;
+
+            for(const auto& arrival : m_stopGraph->arrivals(cellId))
+                if(m_affected[arrival.sourceCellId] && distance + 1 < m_distances[arrival.sourceCellId])
+                {
+                    setEntry(arrival.sourceCellId, distance + 1, arrival.directionIndex, m_targetGems[cellId]);
+
+                    if(buckets.size() <= distance + 1)
+                        buckets.resize(distance + 2);
+
+                    buckets[distance + 1].push_back(arrival.sourceCellId);
+                }
+        }
+
+    for(const auto cellId : affectedCells)
+        m_affected[cellId] = false;
+}
+
+bool GemDistanceField::isEligibleGem(quint32 cellId) const
+{
+    return m_remainingGems[cellId] && (m_canEnterStuckArea || !m_stuckAreaGems[cellId]);
+}
+
+bool GemDistanceField::isAllowedStop(quint32 cellId) const
+{
+    return m_canEnterStuckArea || !m_stuckAreaCells[cellId];
+}
+
+std::optional<quint32> GemDistanceField::firstEligibleGem(quint32 cellId, std::size_t directionIndex) const
+{
+    if(!m_stopGraph->isMove(cellId, directionIndex))
+        return {};
+
+    const auto& slide {m_stopGraph->slide(cellId, directionIndex)};
+
+    if(!isAllowedStop(slide.destination))
+        return {};
+
+    for(const auto coveredCell : m_stopGraph->coveredCells(slide))
+        if(isEligibleGem(coveredCell))
+            return coveredCell;
+
+    return {};
+}
+
+void GemDistanceField::setEntry(quint32 cellId, quint32 distance, std::size_t directionIndex, quint32 gemCellId)
+{
+    m_distances[cellId] = distance;
+    m_firstDirections[cellId] = directionIndex;
+    m_targetGems[cellId] = gemCellId;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common-definitions.hpp"
+#include "stop-graph.hpp"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+
+class GameStateMaintainer;
+
+
+class GemDistanceField
+{
+public:
+
+    void build(const GameStateMaintainer& state);
+    void build(const GameStateMaintainer& state, quint64 boardVersion);
+    bool isBuiltFor(quint64 boardVersion) const;
+
+    void onGemPicked(const GameStateMaintainer& state, quint32 gemCellId);
+    void onGemsRestored(const GameStateMaintainer& state, const std::vector<quint32>& gemCellIds);
+    void syncGems(const GameStateMaintainer& state);
+
+    std::optional<quint32> distance(quint32 cellId) const;
+    std::optional<quint32> targetGem(quint32 cellId) const;
+    Definitions::MovementDirection firstDirection(quint32 cellId) const;
+    std::vector<Definitions::MovementDirection> trace(quint32 cellId) const;
+
+    std::shared_ptr<const StopGraph> stopGraph() const;
+    std::vector<bool> blockedStops() const;
+
+private:
+
+    void computeDistances();
+    void repairAffectedCells(quint32 gemCellId);
+
+    bool isEligibleGem(quint32 cellId) const;
+    bool isAllowedStop(quint32 cellId) const;
+    std::optional<quint32> firstEligibleGem(quint32 cellId, std::size_t directionIndex) const;
+    void setEntry(quint32 cellId, quint32 distance, std::size_t directionIndex, quint32 gemCellId);
+
+    static inline constexpr quint32 kUnreachable = std::numeric_limits<quint32>::max();
+    static inline constexpr qint32 kNoGem = -1;
+
+    std::shared_ptr<const StopGraph> m_stopGraph;
+    std::optional<quint64> m_boardVersion{};
+    bool m_canEnterStuckArea{false};
+    std::vector<bool> m_remainingGems;
+    std::vector<bool> m_stuckAreaGems;
+    std::vector<bool> m_stuckAreaCells;
+    std::vector<quint32> m_distances;
+    std::vector<qint8> m_firstDirections;
+    std::vector<qint32> m_targetGems;
+    std::vector<bool> m_affected;
+};
@@ -1,11 +1,18 @@
 #include "hint-handler.hpp"
+#include "bidirectional-hint-search.hpp"
+#include "stop-graph.hpp"
 #include "state-wrapper.hpp"
+#include "session-log.hpp"
 #include "utility.hpp"
 
-#include <execution>
+#include "engine-scheduler.hpp"
+#include "engine-stats.hpp"
+#include "engine-trace.hpp"
 
+#include <QPointer>
 
-void HintHandler::hint()
+
+void HintHandler::hint(const HintBudget& budget)
 {
     if(m_activeHint)
     {
@@ -15,15 +22,19 @@ void HintHandler::hint()
             invalidateHint();
         }
 
-        else
+        else if(m_hintNeedsReplan)
         {
-            if(InertiaUtility::isValidDirection(*m_hintNextExpectedDir))
-            {
-                StateWrapper::instance().state()->showHint(*m_hintNextExpectedDir);
+            if(replanHint())
+                return;
 
-                if(m_hintNextExpectedDir == m_hintTrace.end())
-                    m_activeHint = false;
+            invalidateHint();
+        }
 
+        else
+        {
+            if(m_hintNextExpectedDir != m_hintTrace.cend() && InertiaUtility::isValidDirection(*m_hintNextExpectedDir))
+            {
+                StateWrapper::instance().state()->showHint(*m_hintNextExpectedDir, m_hintOptimal);
                 return;
             }
 
@@ -32,131 +43,241 @@ void HintHandler::hint()
         }
     }
 
-    const auto nearestGemPos {nearestGem(StateWrapper::instance().state()->ballPos())};
+    const auto& ballPos {StateWrapper::instance().state()->ballPos()};
+    const auto ballCellId {StateWrapper::instance().state()->cellId(ballPos)};
 
-    if(nearestGemPos)
+    if(!budget.time && !budget.memoryBytes)
     {
-        m_hintTargetGem = nearestGemPos.value();
-        shortestWayToGem(StateWrapper::instance().state()->ballPos(), m_hintTargetGem);
+        ensureDistanceField();
 
-        if(m_activeHint)
-        {
-            m_hintNextExpectedDir = m_hintTrace.cbegin();
-            StateWrapper::instance().state()->showHint(*m_hintNextExpectedDir);
-        }
+        if(const auto targetGem {m_distanceField.targetGem(ballCellId)})
+            activateHint(StateWrapper::instance().state()->cellPosition(targetGem.value()), m_distanceField.trace(ballCellId));
+
+        return;
     }
-}
 
-std::optional<Definitions::Position> HintHandler::nearestGem(const Definitions::Position& currentPos)
-{
-    auto& gemsPositions {StateWrapper::instance().state()->gemsPositions()};
+    const auto nearestGemPos {nearestGem(ballPos)};
 
-    if(!gemsPositions.size())
-        return {};
+    if(!nearestGemPos)
+        return;
 
-    if(StateWrapper::instance().state()->canEnterStuckArea())
-        return nearestGemCore(currentPos, gemsPositions);
+    const auto state {StateWrapper::instance().state()};
+    const auto gemCellId {state->cellId(nearestGemPos.value())};
+    auto searchBudget {budget};
+    std::shared_ptr<const StopGraph> stopGraph;
+    std::vector<bool> blockedStops;
+
+    if(m_distanceField.isBuiltFor(state->boardVersion()))
+    {
+        stopGraph = m_distanceField.stopGraph();
+        blockedStops = m_distanceField.blockedStops();
+    }
 
     else
-        return nearestGemCore(currentPos, StateWrapper::instance().state()->hintCandidateGems());
-}
+    {
+        const auto buildStart {std::chrono::steady_clock::now()};
+        auto builtStopGraph {std::make_shared<StopGraph>()};
+        builtStopGraph->build(*state);
 
-bool HintHandler::shortestWayToGem(const Definitions::Position& currentPos,
-                                    const Definitions::Position& gemPos)
-{
-    static uint8_t triesCout {};
+        const auto buildTime {std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - buildStart)};
 
-    if(triesCout++ == kMaxHintRetryCounts)
-    {
-        triesCout = 0;
-        return false;
+        if(searchBudget.time)
+            searchBudget.time = std::max(searchBudget.time.value() - buildTime, std::chrono::milliseconds{});
+
+        if(searchBudget.memoryBytes)
+            searchBudget.memoryBytes = searchBudget.memoryBytes.value() - std::min(searchBudget.memoryBytes.value(), builtStopGraph->allocatedBytes());
+
+        blockedStops.assign(builtStopGraph->cellsCount(), false);
+
+        if(!state->canEnterStuckArea())
+            for(const auto& pos : state->stuckArea())
+                blockedStops[state->cellId(pos)] = true;
+
+        stopGraph = std::move(builtStopGraph);
     }
 
-    if(currentPos == gemPos)
+    AnytimeHintSearch search{*stopGraph, blockedStops, searchBudget};
+    std::optional<HintSearchResult> result;
+
     {
-        triesCout = 0;
-        return false;
+        INERTIA_STATS_SCOPE(HintSearch);
+        INERTIA_TRACE_SCOPE("anytimeHintSearch");
+        result = search.search(ballCellId, gemCellId);
     }
 
-    std::vector<HintBranch> branches {{currentPos, {}}};
-    auto stuckArea {StateWrapper::instance().state()->stuckArea()};
-    std::atomic_bool pathFound{false};
-    std::atomic_bool returnEarly{false};
+    INERTIA_STATS_ADD(HintExpansions, search.expandedNodesCount());
 
-    ShortestWayToGemLoopTask loopTask{this,
-                                      pathFound,
-                                      returnEarly,
-                                      gemPos,
-                                      stuckArea};
+    if(result)
+        activateHint(nearestGemPos.value(), std::move(result->trace), result->optimal);
+}
 
-    while(const auto branchesCount {branches.size()})
-    {
-        if(branchesCount > kMaxBranchesVecSize)
-            return shortestWayToGem(currentPos, gemPos);
+void HintHandler::precomputeHint(QObject* context)
+{
+    const auto state {StateWrapper::instance().state()};
+    const auto boardVersion {state->boardVersion()};
+
+    if(!boardVersion || m_distanceField.isBuiltFor(boardVersion) || m_precomputingBoardVersion == boardVersion)
+        return;
 
-        std::vector<std::optional<std::vector<HintBranch>>> newBranchesVec(branches.size());
+    const auto epoch {++m_precomputeEpoch};
+    m_precomputingBoardVersion = boardVersion;
 
-        std::transform(std::execution::par_unseq,
-                       branches.begin(),
-                       branches.end(),
-                       newBranchesVec.begin(),
-                       loopTask);
+    SessionLog snapshot;
+    snapshot.captureLevel(*state);
+
+    EngineScheduler::instance().submit(TaskPriority::Interactive,
+                                       [this,
+                                        context = QPointer<QObject>(context),
+                                        epoch,
+                                        boardVersion,
+                                        snapshot = std::move(snapshot)]
+    {
+        auto field {std::make_shared<GemDistanceField>()};
 
-        if(pathFound)
         {
-            triesCout = 0;
-            return true;
+            GameStateMaintainer snapshotState{false};
+            const ThreadStateScope threadState {&snapshotState};
+            snapshot.applyLevel(snapshotState);
+            field->build(snapshotState, boardVersion);
         }
 
-        branches.erase(branches.begin(), branches.begin() + branchesCount);
+        if(context)
+            QMetaObject::invokeMethod(context, [this, epoch, field]
+            {
+                adoptPrecomputedField(epoch, std::move(*field));
+            }, Qt::QueuedConnection);
+    });
+}
+
+void HintHandler::activateHint(const Definitions::Position& targetGem,
+                                std::vector<Definitions::MovementDirection> trace,
+                                bool optimal)
+{
+    if(trace.empty())
+        return;
+
+    m_hintTargetGem = targetGem;
+    m_hintTrace = std::move(trace);
+    m_activeHint = true;
+    m_hintNeedsReplan = false;
+    m_hintOptimal = optimal;
+    m_hintNextExpectedDir = m_hintTrace.cbegin();
+    StateWrapper::instance().state()->showHint(*m_hintNextExpectedDir, m_hintOptimal);
+}
+
+bool HintHandler::replanHint()
+{
+    const auto state {StateWrapper::instance().state()};
+    const auto gemCellId {state->cellId(m_hintTargetGem)};
+
+    if(!state->gemIndex().contains(m_hintTargetGem))
+        return false;
+
+    ensureDistanceField();
+
+    const auto ballCellId {state->cellId(state->ballPos())};
+    std::optional<std::vector<Definitions::MovementDirection>> trace;
 
-        std::for_each(newBranchesVec.begin(),
-                      newBranchesVec.end(),
-                      [&branches](auto& newBranches)
-                      { if(newBranches) branches.insert(branches.end(),
-                                        std::make_move_iterator(newBranches->begin()),
-                                        std::make_move_iterator(newBranches->end()));});
+    if(m_searchTree.isRootedAt(gemCellId, state->boardVersion(), state->canEnterStuckArea()))
+        trace = m_searchTree.trace(ballCellId);
+
+    else
+    {
+        trace = shortestWayToGem(*m_distanceField.stopGraph(), m_distanceField.blockedStops(), ballCellId, gemCellId);
+        m_searchTree.reset(m_distanceField.stopGraph(),
+                           m_distanceField.blockedStops(),
+                           gemCellId,
+                           state->boardVersion(),
+                           state->canEnterStuckArea());
     }
 
-    triesCout = 0;
-    return false;
+    if(!trace)
+        return false;
+
+    activateHint(m_hintTargetGem, std::move(trace.value()));
+
+    return true;
+}
+
+std::optional<Definitions::Position> HintHandler::nearestGem(const Definitions::Position& currentPos)
+{
+    auto& gemsPositions {StateWrapper::instance().state()->gemsPositions()};
+
+    if(!gemsPositions.size())
+        return {};
+
+    if(StateWrapper::instance().state()->canEnterStuckArea())
+        return nearestGemCore(currentPos, gemsPositions, [](const Definitions::Position&){ return true; });
+
+    else
+    {
+        const auto& gemIndex {StateWrapper::instance().state()->gemIndex()};
+        return nearestGemCore(currentPos, gemsPositions, [&gemIndex](const Definitions::Position& gemPos){ return !gemIndex.isStuckAreaGem(gemPos); });
+    }
+}
+
+std::optional<std::vector<Definitions::MovementDirection>>
+HintHandler::shortestWayToGem(const StopGraph& stopGraph,
+                               const std::vector<bool>& blockedStops,
+                               quint32 sourceCellId,
+                               quint32 gemCellId) const
+{
+    if(sourceCellId == gemCellId)
+        return {};
+
+    INERTIA_STATS_SCOPE(HintSearch);
+    INERTIA_TRACE_SCOPE("shortestWayToGem");
+
+    BidirectionalHintSearch search{stopGraph, blockedStops};
+    auto result {search.search(sourceCellId, gemCellId)};
+    INERTIA_STATS_ADD(HintExpansions, search.expandedNodesCount());
+
+    return result;
 }
 
 void HintHandler::checkMove(Definitions::MovementDirection moveDir)
 {
-    if(m_activeHint)
+    if(m_activeHint && !m_hintNeedsReplan)
     {
-        if(*m_hintNextExpectedDir == moveDir)
+        if(m_hintNextExpectedDir != m_hintTrace.cend() && *m_hintNextExpectedDir == moveDir)
             ++m_hintNextExpectedDir;
 
         else
-            invalidateHint();
+            m_hintNeedsReplan = true;
     }
 }
 
-void HintHandler::checkUndo(const QList<QPointF>& pickedGems)
+void HintHandler::checkUndo(const std::vector<quint32>& restoredGemCellIds)
 {
-    if(m_activeHint)
+    if(m_activeHint && !m_hintNeedsReplan)
     {
         if(m_hintNextExpectedDir == m_hintTrace.begin())
-            invalidateHint();
+            m_hintNeedsReplan = true;
 
         else
             --m_hintNextExpectedDir;
     }
 
-    for(const auto& point : pickedGems)
-    {
-        Definitions::Position gemPos(point.y(), point.x());
+    const auto state {StateWrapper::instance().state()};
 
-        if(!StateWrapper::instance().state()->stuckArea().contains(gemPos))
-            StateWrapper::instance().state()->hintCandidateGems().insert(gemPos);
-    }
+    if(m_distanceField.isBuiltFor(state->boardVersion()))
+        m_distanceField.onGemsRestored(*state, restoredGemCellIds);
+}
+
+void HintHandler::checkRestart(const std::vector<quint32>& restoredGemCellIds)
+{
+    invalidateHint();
+
+    const auto state {StateWrapper::instance().state()};
+
+    if(m_distanceField.isBuiltFor(state->boardVersion()))
+        m_distanceField.onGemsRestored(*state, restoredGemCellIds);
 }
 
 void HintHandler::invalidateHint()
 {
     m_activeHint = false;
+    m_hintNeedsReplan = false;
     m_hintNextExpectedDir = m_hintTrace.cend();
     std::vector<Definitions::MovementDirection>{}.swap(m_hintTrace);
 }
@@ -166,73 +287,32 @@ void HintHandler::onGemPicked(quint32 rowIndex, quint32 columnIndex)
     if(m_hintTargetGem == Definitions::Position{rowIndex, columnIndex})
         invalidateHint();
 
-    StateWrapper::instance().state()->hintCandidateGems().erase(Definitions::Position(rowIndex, columnIndex));
+    const auto state {StateWrapper::instance().state()};
+
+    if(m_distanceField.isBuiltFor(state->boardVersion()))
+        m_distanceField.onGemPicked(*state, state->cellId(Definitions::Position{rowIndex, columnIndex}));
 }
 
-HintHandler::ShortestWayToGemLoopTask::ShortestWayToGemLoopTask(HintHandler* hintHandler,
-                                                                  std::atomic_bool& pathFound,
-                                                                  std::atomic_bool& returnEarly,
-                                                                  const Definitions::Position& gemPos,
-                                                                  std::unordered_set<Definitions::Position>& stuckArea) :
-    m_hintHandler(hintHandler),
-    m_pathFound(pathFound),
-    m_returnEarly(returnEarly),
-    m_gemPos(gemPos),
-    m_stuckArea(stuckArea)
+void HintHandler::ensureDistanceField()
 {
+    const auto state {StateWrapper::instance().state()};
 
+    if(!m_distanceField.isBuiltFor(state->boardVersion()))
+        m_distanceField.build(*state);
 }
 
-std::optional<std::vector<HintBranch>> HintHandler::ShortestWayToGemLoopTask::operator()(HintBranch& branch) const
+void HintHandler::adoptPrecomputedField(quint64 epoch, GemDistanceField field)
 {
-    std::vector<HintBranch> newBranches;
-    const auto& dirs {InertiaUtility::orderedDirections(branch.currentPos, m_gemPos)};
-
-    HintBranch newBranch;
-    Definitions::Position finalPos;
-    bool safeFinalPos;
-    std::optional<std::unordered_set<Definitions::Position>> trace{};
-
-    for(const auto dir : dirs)
-    {
-        if(m_returnEarly)
-            return {};
-
-        std::tie (finalPos, safeFinalPos, trace) =
-            StateWrapper::instance().state()->finalDestinationPlusTrace(branch.currentPos, dir);
+    if(epoch != m_precomputeEpoch)
+        return;
 
-        if(!safeFinalPos || finalPos == branch.currentPos || branch.stoppedByCells.contains(finalPos))
-            continue;
+    m_precomputingBoardVersion.reset();
 
+    const auto state {StateWrapper::instance().state()};
 
-        if(trace->contains(m_gemPos))
-        {
-            if(m_returnEarly)
-                return {};
-
-            if(m_stuckArea.contains(finalPos) &&
-                !StateWrapper::instance().state()->canEnterStuckArea())
-                continue;
-
-            branch.track.push_back(dir);
-            m_hintHandler->m_hintTrace = branch.track;
-            m_hintHandler->m_activeHint = true;
-            m_returnEarly.store(true);
-            m_pathFound.store(true);
-            return {};
-        }
-
-        if(m_returnEarly)
-            return {};
-
-        newBranch.currentPos = finalPos;
-        newBranch.stoppedByCells = branch.stoppedByCells;
-        newBranch.stoppedByCells.insert(finalPos);
-        newBranch.track = branch.track;
-        newBranch.track.push_back(dir);
-
-        newBranches.push_back(std::move(newBranch));
-    }
+    if(!field.isBuiltFor(state->boardVersion()) || m_distanceField.isBuiltFor(state->boardVersion()))
+        return;
 
-    return newBranches;
+    m_distanceField = std::move(field);
+    m_distanceField.syncGems(*state);
 }
@@ -1,84 +1,81 @@
 #pragma once
 
 #include "common-definitions.hpp"
+#include "anytime-hint-search.hpp"
+#include "gem-distance-field.hpp"
+#include "hint-search-tree.hpp"
 #include "utility.hpp"
 
 #include <unordered_set>
 
 
 class GameStateMaintainer;
-
-
-struct HintBranch
-{
-    Definitions::Position currentPos;
-    std::unordered_set<Definitions::Position> stoppedByCells;
-    std::vector<Definitions::MovementDirection> track;
-};
+class QObject;
 
 
 class HintHandler
 {
-
-    struct ShortestWayToGemLoopTask
-    {
-        ShortestWayToGemLoopTask(HintHandler* hintHandler,
-                                   std::atomic_bool& pathFound,
-                                   std::atomic_bool& returnEarly,
-                                   const Definitions::Position& gemPos,
-                                   std::unordered_set<Definitions::Position>& stuckArea);
-
-        std::optional<std::vector<HintBranch>> operator()(HintBranch& branch) const;
-
-    private:
-
-        HintHandler* m_hintHandler {};
-        std::atomic_bool& m_pathFound;
-        std::atomic_bool& m_returnEarly;
-        const Definitions::Position& m_gemPos;
-        std::unordered_set<Definitions::Position>& m_stuckArea;
-    };
+    friend class EngineBenchmark;
 
 public:
 
-    void hint();
+    void hint(const HintBudget& budget = {});
+    void precomputeHint(QObject* context);
     void checkMove(Definitions::MovementDirection moveDir);
-    void checkUndo(const QList<QPointF>& pickedGems);
+    void checkUndo(const std::vector<quint32>& restoredGemCellIds);
+    void checkRestart(const std::vector<quint32>& restoredGemCellIds);
     void onGemPicked(quint32 rowIndex, quint32 columnIndex);
 
 private:
 
     std::optional<Definitions::Position> nearestGem(const Definitions::Position& currentPos);
 
-    template<typename Container>
+    template<typename Predicate>
     Definitions::Position nearestGemCore(const Definitions::Position& currentPos,
-                                                         const Container& candidateGems);
+                                                         const std::vector<Definitions::Position>& gemsPositions,
+                                                         Predicate isCandidate);
+
+    std::optional<std::vector<Definitions::MovementDirection>>
+    shortestWayToGem(const StopGraph& stopGraph,
+                       const std::vector<bool>& blockedStops,
+                       quint32 sourceCellId,
+                       quint32 gemCellId) const;
+
+    void ensureDistanceField();
+    void adoptPrecomputedField(quint64 epoch, GemDistanceField field);
+    void activateHint(const Definitions::Position& targetGem,
+                       std::vector<Definitions::MovementDirection> trace,
+                       bool optimal = true);
+    bool replanHint();
 
-    bool shortestWayToGem(const Definitions::Position& currentPos, const Definitions::Position& gemPos);
     void invalidateHint();
 
 
-    static inline constexpr uint32_t kMaxBranchesVecSize = 500000;
-    static inline constexpr uint8_t kMaxHintRetryCounts = 20;
-
     bool m_activeHint{false};
+    bool m_hintNeedsReplan{false};
+    bool m_hintOptimal{true};
     std::vector<Definitions::MovementDirection> m_hintTrace{};
     Definitions::Position m_hintTargetGem;
     std::vector<Definitions::MovementDirection>::const_iterator m_hintNextExpectedDir;
+    GemDistanceField m_distanceField;
+    quint64 m_precomputeEpoch{};
+    std::optional<quint64> m_precomputingBoardVersion{};
+    HintSearchTree m_searchTree;
 };
 
 
-template<typename ContainerType>
+template<typename Predicate>
 Definitions::Position
 HintHandler::nearestGemCore(const Definitions::Position& currentPos,
-                             const ContainerType& candidateGems)
+                             const std::vector<Definitions::Position>& gemsPositions,
+                             Predicate isCandidate)
 {
     double minDistance{std::numeric_limits<double>::infinity()};
 
-    typename  ContainerType::const_iterator resultIt;
+    std::vector<Definitions::Position>::const_iterator resultIt;
 
-    for(auto it {candidateGems.cbegin()}; it != candidateGems.cend(); ++it)
-        if(auto dist {InertiaUtility::distance(currentPos, *it)}; dist < minDistance)
+    for(auto it {gemsPositions.cbegin()}; it != gemsPositions.cend(); ++it)
+        if(auto dist {InertiaUtility::distance(currentPos, *it)}; isCandidate(*it) && dist < minDistance)
         {
             minDistance = dist;
             resultIt = it;
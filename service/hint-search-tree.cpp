@@ -0,0 +1,115 @@
+#include "hint-search-tree.hpp"
+#include "stop-graph.hpp"
+#include "constants.hpp"
+
+
+void HintSearchTree::reset(std::shared_ptr<const StopGraph> stopGraph,
+                            std::vector<bool> blockedStops,
+                            quint32 gemCellId,
+                            quint64 boardVersion,
+                            bool canEnterStuckArea)
+{
+    m_stopGraph = std::move(stopGraph);
+    m_blockedStops = std::move(blockedStops);
+    m_gemCellId = gemCellId;
+    m_boardVersion = boardVersion;
+    m_canEnterStuckArea = canEnterStuckArea;
+    m_expandedNodesCount = 0;
+
+    const auto cellsCount {m_stopGraph->cellsCount()};
+
+    m_distances.assign(cellsCount, kUnreachable);
+    m_nexts.assign(cellsCount, 0);
+    m_directions.assign(cellsCount, -1);
+    m_frontier.clear();
+
+    for(const auto& coverer : m_stopGraph->coverers(gemCellId))
+    {
+        const auto cellId {coverer.sourceCellId};
+
+        if(m_distances[cellId] != kUnreachable ||
+            m_blockedStops[m_stopGraph->slide(cellId, coverer.directionIndex).destination])
+            continue;
+
+        m_distances[cellId] = 1;
+        m_directions[cellId] = coverer.directionIndex;
+        m_frontier.push_back(cellId);
+    }
+}
+
+void HintSearchTree::clear()
+{
+    m_stopGraph.reset();
+    m_gemCellId.reset();
+    std::vector<bool>{}.swap(m_blockedStops);
+    std::vector<quint32>{}.swap(m_distances);
+    std::vector<quint32>{}.swap(m_nexts);
+    std::vector<qint8>{}.swap(m_directions);
+    std::vector<quint32>{}.swap(m_frontier);
+    std::vector<quint32>{}.swap(m_nextFrontier);
+}
+
+bool HintSearchTree::isRootedAt(quint32 gemCellId, quint64 boardVersion, bool canEnterStuckArea) const
+{
+    return m_gemCellId == gemCellId && m_boardVersion == boardVersion && m_canEnterStuckArea == canEnterStuckArea;
+}
+
+std::optional<std::vector<Definitions::MovementDirection>> HintSearchTree::trace(quint32 cellId)
+{
+    if(!m_gemCellId || cellId >= m_distances.size() || !settle(cellId))
+        return {};
+
+    std::vector<Definitions::MovementDirection> result;
+    result.reserve(m_distances[cellId]);
+
+    for(; ; cellId = m_nexts[cellId])
+    {
+        result.push_back(Constants::kAllDirections[m_directions[cellId]]);
+
+        if(m_distances[cellId] == 1)
+            break;
+    }
+
+    return result;
+}
+
+quint64 HintSearchTree::expandedNodesCount() const
+{
+    return m_expandedNodesCount;
+}
+
+bool HintSearchTree::settle(quint32 cellId)
+{
+    while(m_distances[cellId] == kUnreachable && m_frontier.size())
+        expandLevel();
+
+    return m_distances[cellId] != kUnreachable;
+}
+
+void HintSearchTree::expandLevel()
+{
+    m_nextFrontier.clear();
+
+    for(const auto cellId : m_frontier)
+    {
+        ++m_expandedNodesCount;
+
+        if(m_blockedStops[cellId])
+            continue;
+
+        for(const auto& arrival : m_stopGraph->arrivals(cellId))
+        {
+            const auto predecessor {arrival.sourceCellId};
+
+            if(m_distances[predecessor] != kUnreachable)
+                continue;
+
+            m_distances[predecessor] = m_distances[cellId] + 1;
+            m_nexts[predecessor] = cellId;
+            m_directions[predecessor] = arrival.directionIndex;
+            m_nextFrontier.push_back(predecessor);
+        }
+    }
+
+    m_frontier.swap(m_nextFrontier);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+
+class StopGraph;
+
+
+class HintSearchTree
+{
+public:
+
+    void reset(std::shared_ptr<const StopGraph> stopGraph,
+                std::vector<bool> blockedStops,
+                quint32 gemCellId,
+                quint64 boardVersion,
+                bool canEnterStuckArea);
+
+    void clear();
+    bool isRootedAt(quint32 gemCellId, quint64 boardVersion, bool canEnterStuckArea) const;
+
+    std::optional<std::vector<Definitions::MovementDirection>> trace(quint32 cellId);
+    quint64 expandedNodesCount() const;
+
+private:
+
+    bool settle(quint32 cellId);
+    void expandLevel();
+
+    static inline constexpr quint32 kUnreachable = std::numeric_limits<quint32>::max();
+
+    std::shared_ptr<const StopGraph> m_stopGraph;
+    std::vector<bool> m_blockedStops;
+    std::optional<quint32> m_gemCellId{};
+    quint64 m_boardVersion{};
+    bool m_canEnterStuckArea{false};
+
+    std::vector<quint32> m_distances, m_nexts;
+    std::vector<qint8> m_directions;
+    std::vector<quint32> m_frontier, m_nextFrontier;
+    quint64 m_expandedNodesCount{};
+};
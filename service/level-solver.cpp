@@ -0,0 +1,245 @@
+#include "level-solver.hpp"
+#include "stop-graph.hpp"
+#include "constants.hpp"
+
+#include <numeric>
+#include <queue>
+#include <unordered_set>
+
+
+std::optional<std::vector<Definitions::MovementDirection>>
+LevelSolver::solve(const StopGraph& stopGraph,
+                   quint32 ballCellId,
+                   const std::vector<quint32>& gemCellIds)
+{
+    if(!stopGraph.isBuilt() || gemCellIds.size() > kMaxGemsCount)
+        return {};
+
+    computeGemDistances(stopGraph, gemCellIds);
+
+    m_nodes.clear();
+
+    Node root{ballCellId};
+
+    for(std::size_t gemIndex{}; gemIndex < gemCellIds.size(); ++gemIndex)
+        root.remainingGems.set(gemIndex);
+
+    const auto rootEstimate {heuristic(ballCellId, root.remainingGems)};
+
+    if(!rootEstimate)
+        return {};
+
+    m_nodes.push_back(root);
+
+    std::unordered_set<quint32, NodeHash, NodeEqual> transpositions(0, NodeHash{&m_nodes}, NodeEqual{&m_nodes});
+    std::priority_queue<OpenEntry> openEntries;
+    std::vector<bool> closed{false};
+
+    transpositions.insert(0);
+    openEntries.push({rootEstimate.value(), 0, 0});
+
+    while(openEntries.size())
+    {
+        const auto entry {openEntries.top()};
+        openEntries.pop();
+
+        if(closed[entry.nodeIndex] || entry.movesCount != m_nodes[entry.nodeIndex].movesCount)
+            continue;
+
+        closed[entry.nodeIndex] = true;
+
+        if(m_nodes[entry.nodeIndex].remainingGems.none())
+            return tracePath(entry.nodeIndex);
+
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+        {
+            const auto& current {m_nodes[entry.nodeIndex]};
+
+            if(!stopGraph.isMove(current.cellId, dirIndex))
+                continue;
+
+            Node child{stopGraph.slide(current.cellId, dirIndex).destination,
+                       current.movesCount + 1,
+                       entry.nodeIndex,
+                       static_cast<qint8>(dirIndex),
+                       current.remainingGems & ~collectedGems(stopGraph, current.cellId, dirIndex)};
+
+            const auto childEstimate {heuristic(child.cellId, child.remainingGems)};
+
+            if(!childEstimate)
+                continue;
+
+            if(m_nodes.size() == kMaxGeneratedNodes)
+                return {};
+
+            m_nodes.push_back(std::move(child));
+            const auto childIndex {static_cast<quint32>(m_nodes.size() - 1)};
+
+            if(auto [it, inserted] {transpositions.insert(childIndex)}; !inserted)
+            {
+                auto& known {m_nodes[*it]};
+                const auto improved {m_nodes.back().movesCount < known.movesCount};
+
+                if(improved)
+                {
+                    known.movesCount = m_nodes.back().movesCount;
+                    known.parent = m_nodes.back().parent;
+                    known.directionIndex = m_nodes.back().directionIndex;
+                    closed[*it] = false;
+                }
+
+                m_nodes.pop_back();
+
+                if(!improved)
+                    continue;
+
+                openEntries.push({known.movesCount + childEstimate.value(), known.movesCount, *it});
+                continue;
+            }
+
+            closed.push_back(false);
+            openEntries.push({m_nodes.back().movesCount + childEstimate.value(), m_nodes.back().movesCount, childIndex});
+        }
+    }
+
+    return {};
+}
+
+void LevelSolver::computeGemDistances(const StopGraph& stopGraph, const std::vector<quint32>& gemCellIds)
+{
+    m_cellsCount = stopGraph.cellsCount();
+    m_gemOfCell.assign(m_cellsCount, -1);
+
+    for(std::size_t gemIndex{}; gemIndex < gemCellIds.size(); ++gemIndex)
+        m_gemOfCell[gemCellIds[gemIndex]] = gemIndex;
+
+    m_gemDistances.assign(gemCellIds.size(), std::vector<quint16>(m_cellsCount, kUnreachable));
+    m_sharedSlideGems.assign(gemCellIds.size(), {});
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        for(std::size_t dirIndex{}; dirIndex < StopGraph::kDirectionsCount; ++dirIndex)
+        {
+            if(!stopGraph.isMove(cellId, dirIndex))
+                continue;
+
+            const auto slideGems {collectedGems(stopGraph, cellId, dirIndex)};
+
+            for(const auto coveredCell : stopGraph.coveredCells(stopGraph.slide(cellId, dirIndex)))
+                if(const auto gemIndex {m_gemOfCell[coveredCell]}; gemIndex >= 0)
+                {
+                    m_gemDistances[gemIndex][cellId] = 1;
+                    m_sharedSlideGems[gemIndex] |= slideGems;
+                }
+        }
+
+    m_gemsOrder.resize(gemCellIds.size());
+    std::iota(m_gemsOrder.begin(), m_gemsOrder.end(), 0);
+
+    std::stable_sort(m_gemsOrder.begin(),
+                     m_gemsOrder.end(),
+                     [this](quint32 lhs, quint32 rhs)
+                     { return m_sharedSlideGems[lhs].count() < m_sharedSlideGems[rhs].count(); });
+
+    std::vector<quint32> queue;
+
+    for(auto& distances : m_gemDistances)
+    {
+        queue.clear();
+
+        for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+            if(distances[cellId] == 1)
+                queue.push_back(cellId);
+
+        for(std::size_t i{}; i < queue.size(); ++i)
+        {
+            const auto cellId {queue[i]};
+
+            for(const auto& predecessor : stopGraph.arrivals(cellId))
+                if(distances[predecessor.sourceCellId] == kUnreachable)
+                {
+                    distances[predecessor.sourceCellId] = distances[cellId] + 1;
+                    queue.push_back(predecessor.sourceCellId);
+                }
+        }
+    }
+}
+
+std::optional<quint32> LevelSolver::heuristic(quint32 cellId, const GemsMask& remainingGems) const
+{
+    if(remainingGems.none())
+        return 0;
+
+    quint32 nearestGemDistance {kUnreachable};
+    quint32 farthestGemDistance {};
+    quint32 separateMovesCount {};
+    GemsMask separateGems;
+
+    for(const auto gemIndex : m_gemsOrder)
+    {
+        if(!remainingGems.test(gemIndex))
+            continue;
+
+        const quint32 distance {m_gemDistances[gemIndex][cellId]};
+
+        if(distance == kUnreachable)
+            return {};
+
+        nearestGemDistance = std::min(nearestGemDistance, distance);
+        farthestGemDistance = std::max(farthestGemDistance, distance);
+
+        if((m_sharedSlideGems[gemIndex] & separateGems).none())
+        {
+            separateGems.set(gemIndex);
+            ++separateMovesCount;
+        }
+    }
+
+    return std::max(farthestGemDistance, nearestGemDistance + separateMovesCount - 1);
+}
+
+LevelSolver::GemsMask LevelSolver::collectedGems(const StopGraph& stopGraph,
+                                                 quint32 cellId,
+                                                 std::size_t directionIndex) const
+{
+    GemsMask result;
+
+    for(const auto coveredCell : stopGraph.coveredCells(stopGraph.slide(cellId, directionIndex)))
+        if(const auto gemIndex {m_gemOfCell[coveredCell]}; gemIndex >= 0)
+            result.set(gemIndex);
+
+    return result;
+}
+
+std::vector<Definitions::MovementDirection> LevelSolver::tracePath(quint32 nodeIndex) const
+{
+    std::vector<Definitions::MovementDirection> result;
+
+    for(auto index {nodeIndex}; m_nodes[index].directionIndex >= 0; index = m_nodes[index].parent)
+        result.push_back(Constants::kAllDirections[m_nodes[index].directionIndex]);
+
+    std::reverse(result.begin(), result.end());
+
+    return result;
+}
+
+bool LevelSolver::OpenEntry::operator<(const OpenEntry& other) const
+{
+    if(estimatedCost != other.estimatedCost)
+        return estimatedCost > other.estimatedCost;
+
+    return movesCount < other.movesCount;
+}
+
+std::size_t LevelSolver::NodeHash::operator()(quint32 nodeIndex) const
+{
+    const auto& node {(*nodes)[nodeIndex]};
+    return std::hash<GemsMask>{}(node.remainingGems) ^ (std::hash<quint32>{}(node.cellId) * 0x9E3779B97F4A7C15ULL);
+}
+
+bool LevelSolver::NodeEqual::operator()(quint32 lhs, quint32 rhs) const
+{
+    const auto& lhsNode {(*nodes)[lhs]};
+    const auto& rhsNode {(*nodes)[rhs]};
+
+    return lhsNode.cellId == rhsNode.cellId && lhsNode.remainingGems == rhsNode.remainingGems;
+}
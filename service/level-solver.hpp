@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <bitset>
+#include <optional>
+#include <vector>
+
+
+class StopGraph;
+
+
+class LevelSolver
+{
+public:
+
+    static inline constexpr std::size_t kMaxGemsCount = 256;
+    static inline constexpr std::size_t kMaxGeneratedNodes = 2000000;
+
+    using GemsMask = std::bitset<kMaxGemsCount>;
+
+    std::optional<std::vector<Definitions::MovementDirection>> solve(const StopGraph& stopGraph,
+                                                                     quint32 ballCellId,
+                                                                     const std::vector<quint32>& gemCellIds);
+
+private:
+
+    struct Node
+    {
+        quint32 cellId{};
+        quint32 movesCount{};
+        quint32 parent{};
+        qint8 directionIndex{-1};
+        GemsMask remainingGems;
+    };
+
+    struct OpenEntry
+    {
+        quint32 estimatedCost{};
+        quint32 movesCount{};
+        quint32 nodeIndex{};
+
+        bool operator<(const OpenEntry& other) const;
+    };
+
+    struct NodeHash
+    {
+        const std::vector<Node>* nodes{};
+        std::size_t operator()(quint32 nodeIndex) const;
+    };
+
+    struct NodeEqual
+    {
+        const std::vector<Node>* nodes{};
+        bool operator()(quint32 lhs, quint32 rhs) const;
+    };
+
+    void computeGemDistances(const StopGraph& stopGraph, const std::vector<quint32>& gemCellIds);
+    std::optional<quint32> heuristic(quint32 cellId, const GemsMask& remainingGems) const;
+    GemsMask collectedGems(const StopGraph& stopGraph, quint32 cellId, std::size_t directionIndex) const;
+    std::vector<Definitions::MovementDirection> tracePath(quint32 nodeIndex) const;
+
+    static inline constexpr quint16 kUnreachable = std::numeric_limits<quint16>::max();
+
+    quint32 m_cellsCount{};
+    std::vector<qint32> m_gemOfCell;
+    std::vector<std::vector<quint16>> m_gemDistances;
+    std::vector<GemsMask> m_sharedSlideGems;
+    std::vector<quint32> m_gemsOrder;
+    std::vector<Node> m_nodes;
+};
@@ -1,5 +1,10 @@
 #include "service/move-handler.hpp"
+#include "service/level-solver.hpp"
+#include "service/engine-scheduler.hpp"
 #include "state-wrapper.hpp"
+#include "stop-graph.hpp"
+#include "utility.hpp"
+#include "constants.hpp"
 
 
 using namespace Definitions;
@@ -12,96 +17,71 @@ MoveHandler::MoveHandler() : m_hintHandler(std::make_unique<HintHandler>())
 
 MovementResult MoveHandler::moveBall(MovementDirection direction)
 {
-    m_hintHandler->checkMove(direction);
+    const auto state {StateWrapper::instance().state()};
+    CellChangesBatch cellChanges{state};
 
-    auto ballPos {StateWrapper::instance().state()->ballPos()};
-    std::optional<Position> currentPos {ballPos};
-    auto previousPos {currentPos.value()};
-    CellType currentCellType;
-    QPointF finalPos;
-    bool emitDataChanged {false};
-    bool checkGameCompletion {false};
-    bool updateBallPos {false};
-    bool exitLoop {false};
+    const auto slide {slideBall(direction)};
     QList<QPointF> collectedGems;
 
-    while(true)
+    for(const auto gemCellId : slide.gemCellIds)
     {
-        previousPos = currentPos.value();
-        currentPos = StateWrapper::instance().state()->nextCellPos(currentPos.value(), direction);
+        const auto gemPos {state->cellPosition(gemCellId)};
+        collectedGems.emplace_back(gemPos.columnIndex, gemPos.rowIndex);
+    }
 
-        if(currentPos)
-            currentCellType = StateWrapper::instance().state()->cellAt(currentPos->rowIndex, currentPos->columnIndex);
+    state->notifyBallPosChange(state->ballPos());
 
-        if(!currentPos || currentCellType == CellType::Wall)
-        {
-            finalPos = QPointF(previousPos.columnIndex, previousPos.rowIndex);
-            updateBallPos = true;
-            exitLoop = true;
-        }
+    if(slide.gemCellIds.size() && !state->remainingGemsCount())
+        state->notifyGameCompletion();
 
-        else if(currentCellType == CellType::Mine)
-        {
-            updateBallPos = true;
-            emitDataChanged = true;
-            exitLoop = true;
-            StateWrapper::instance().state()->cellAt(currentPos->rowIndex, currentPos->columnIndex) = CellType::Exploded;
-            finalPos = QPointF(currentPos->columnIndex, currentPos->rowIndex);
-        }
+    return {QPointF(slide.finalPos.columnIndex, slide.finalPos.rowIndex), std::move(collectedGems)};
+}
 
-        else if(currentCellType == CellType::Gem)
-        {
-            StateWrapper::instance().state()->cellAt(currentPos->rowIndex, currentPos->columnIndex) = CellType::Waiting;
-            collectedGems.emplace_back(currentPos->columnIndex, currentPos->rowIndex);
-            checkGameCompletion = true;
-            onGemPicked(currentPos->rowIndex, currentPos->columnIndex);
-        }
+MovementSequenceResult MoveHandler::moveBallSequence(const QList<MovementDirection>& directions)
+{
+    const auto state {StateWrapper::instance().state()};
+    QList<qint32> gemsPerStep;
+    QList<qint32> collectedGemCellIds;
+    qint32 explosionIndex {-1};
+    CellChangesBatch cellChanges{state};
 
-        else if(currentCellType == CellType::Stop)
-        {
-            updateBallPos = true;
-            exitLoop = true;
-            finalPos = QPointF(currentPos->columnIndex, currentPos->rowIndex);
-        }
+    gemsPerStep.reserve(directions.size());
 
+    for(qint32 step{}; step < directions.size() && explosionIndex < 0; ++step)
+    {
+        const auto slide {slideBall(directions[step])};
 
-        if(updateBallPos)
-        {
-            updateBallPos = false;
-            auto& ballPos {StateWrapper::instance().state()->ballPos()};
-            ballPos.rowIndex = finalPos.y();
-            ballPos.columnIndex = finalPos.x();
-            StateWrapper::instance().state()-> notifyBallPosChange(ballPos);
-        }
+        gemsPerStep.push_back(slide.gemCellIds.size());
 
-        if(emitDataChanged)
-        {
-            emitDataChanged = false;
-            auto indx {StateWrapper::instance().state()->index(currentPos->rowIndex, currentPos->columnIndex)};
-            StateWrapper::instance().state()->notifyDataChange(indx, indx);
-        }
+        for(const auto gemCellId : slide.gemCellIds)
+            collectedGemCellIds.push_back(gemCellId);
 
-        if(checkGameCompletion)
-        {
-            checkGameCompletion = false;
+        if(slide.exploded)
+            explosionIndex = step;
+    }
 
-            if(!StateWrapper::instance().state()->remainingGemsCount())
-                StateWrapper::instance().state()->notifyGameCompletion();
-        }
+    const auto& ballPos {state->ballPos()};
+    state->notifyBallPosChange(ballPos);
 
-        if(exitLoop)
-            return {finalPos, std::move(collectedGems)};
-    }
+    if(collectedGemCellIds.size() && !state->remainingGemsCount())
+        state->notifyGameCompletion();
+
+    return {QPointF(ballPos.columnIndex, ballPos.rowIndex),
+            std::move(gemsPerStep),
+            std::move(collectedGemCellIds),
+            explosionIndex};
 }
 
 void MoveHandler::undo(QPointF preMovePos, QList<QPointF> pickedGems)
 {
+    CellChangesBatch cellChanges{StateWrapper::instance().state()};
+
     for(const auto& point : pickedGems)
     {
         const auto px {point.x()};
         const auto py {point.y()};
-        StateWrapper::instance().state()->gemsPositions().emplace_back(py, px);
-        StateWrapper::instance().state()->cellAt(py, px) = CellType::Gem;
+        StateWrapper::instance().state()->gemIndex().add(Position(py, px));
+        StateWrapper::instance().state()->setCellType(Position(py, px), CellType::Gem);
     }
 
     StateWrapper::instance().state()->remainingGemsCount() += pickedGems.size();
@@ -112,24 +92,225 @@ void MoveHandler::undo(QPointF preMovePos, QList<QPointF> pickedGems)
 
     StateWrapper::instance().state()->notifyBallPosChange(ballPos);
 
+    std::vector<quint32> restoredGemCellIds;
+
     for(const auto& point : pickedGems)
+        restoredGemCellIds.push_back(StateWrapper::instance().state()->cellId(Position(point.y(), point.x())));
+
+    journal().undo();
+    recordSessionEvent(SessionLog::EventKind::Undo);
+    m_hintHandler->checkUndo(restoredGemCellIds);
+}
+
+bool MoveHandler::undoLastMove()
+{
+    const auto state {StateWrapper::instance().state()};
+    const auto record {journal().undo()};
+
+    if(!record)
+        return false;
+
+    recordSessionEvent(SessionLog::EventKind::Undo);
+
+    const auto gemCells {m_journal.gemCells(record.value())};
+    CellChangesBatch cellChanges{state};
+
+    for(const auto gemCellId : gemCells)
+    {
+        const auto gemPos {state->cellPosition(gemCellId)};
+        state->setCellType(gemPos, CellType::Gem);
+        state->gemIndex().add(gemPos);
+    }
+
+    state->remainingGemsCount() += gemCells.size();
+
+    if(record->explodedMine)
+    {
+        const auto minePos {state->cellPosition(record->endCellId)};
+        state->setCellType(minePos, CellType::Mine);
+    }
+
+    state->ballPos() = state->cellPosition(record->startCellId);
+    state->notifyBallPosChange(state->ballPos());
+
+    m_hintHandler->checkUndo({gemCells.begin(), gemCells.end()});
+
+    return true;
+}
+
+bool MoveHandler::redoMove()
+{
+    const auto state {StateWrapper::instance().state()};
+    const auto record {journal().redo()};
+
+    if(!record)
+        return false;
+
+    recordSessionEvent(SessionLog::EventKind::Move, record->directionIndex);
+    m_hintHandler->checkMove(Constants::kAllDirections[record->directionIndex]);
+
+    const auto gemCells {m_journal.gemCells(record.value())};
+    CellChangesBatch cellChanges{state};
+
+    for(const auto gemCellId : gemCells)
+    {
+        const auto gemPos {state->cellPosition(gemCellId)};
+        state->setCellType(gemPos, CellType::Clear);
+        onGemPicked(gemPos.rowIndex, gemPos.columnIndex);
+    }
+
+    if(record->explodedMine)
     {
-        auto modelIndex {StateWrapper::instance().state()->index(point.y(), point.x())};
-        StateWrapper::instance().state()->notifyDataChange(modelIndex, modelIndex);
+        const auto minePos {state->cellPosition(record->endCellId)};
+        state->setCellType(minePos, CellType::Exploded);
     }
 
-    m_hintHandler->checkUndo(pickedGems);
+    state->ballPos() = state->cellPosition(record->endCellId);
+    state->notifyBallPosChange(state->ballPos());
+
+    if(gemCells.size() && !state->remainingGemsCount())
+        state->notifyGameCompletion();
+
+    return true;
 }
 
-void MoveHandler::hint()
+void MoveHandler::restartGame()
 {
-    m_hintHandler->hint();
+    const auto state {StateWrapper::instance().state()};
+    const auto restoredGemCellIds {state->restartGame()};
+
+    m_journal.reset(state->boardVersion());
+
+    if(m_sessionRecorder.isRecordingFor(state->boardVersion()))
+        m_sessionRecorder.start(*state);
+
+    m_hintHandler->checkRestart(restoredGemCellIds);
+}
+
+bool MoveHandler::canUndo() const
+{
+    return m_journal.isFor(StateWrapper::instance().state()->boardVersion()) && m_journal.canUndo();
+}
+
+bool MoveHandler::canRedo() const
+{
+    return m_journal.isFor(StateWrapper::instance().state()->boardVersion()) && m_journal.canRedo();
+}
+
+void MoveHandler::hint(const HintBudget& budget)
+{
+    recordSessionEvent(SessionLog::EventKind::Hint);
+    m_hintHandler->hint(budget);
+}
+
+void MoveHandler::precomputeHint(QObject* context)
+{
+    m_hintHandler->precomputeHint(context);
+}
+
+void MoveHandler::solve()
+{
+    const auto state {StateWrapper::instance().state()};
+
+    auto stopGraph {std::make_shared<StopGraph>()};
+    stopGraph->build(*state);
+
+    std::vector<quint32> gemCellIds;
+
+    for(const auto& gemPos : state->gemsPositions())
+        gemCellIds.push_back(state->cellId(gemPos));
+
+    EngineScheduler::instance().submit(TaskPriority::Interactive,
+                                       [state,
+                                        stopGraph = std::move(stopGraph),
+                                        ballCellId = state->cellId(state->ballPos()),
+                                        gemCellIds = std::move(gemCellIds)]
+    {
+        LevelSolver solver;
+        auto solution {solver.solve(*stopGraph, ballCellId, gemCellIds).value_or(std::vector<MovementDirection>{})};
+
+        QMetaObject::invokeMethod(state, [state, solution = std::move(solution)]
+        {
+            state->notifySolution(solution);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MoveHandler::startSessionRecording()
+{
+    m_sessionRecorder.start(*StateWrapper::instance().state());
+}
+
+std::optional<SessionLog> MoveHandler::stopSessionRecording()
+{
+    return m_sessionRecorder.stop();
+}
+
+MoveHandler::SlideResult MoveHandler::slideBall(MovementDirection direction)
+{
+    const auto state {StateWrapper::instance().state()};
+    const auto startCellId {state->cellId(state->ballPos())};
+    SlideResult result {state->ballPos()};
+
+    m_hintHandler->checkMove(direction);
+
+    while(const auto nextPos {state->nextCellPos(result.finalPos, direction)})
+    {
+        const auto cellType {state->cellAt(nextPos->rowIndex, nextPos->columnIndex)};
+
+        if(cellType == CellType::Wall)
+            break;
+
+        result.finalPos = nextPos.value();
+
+        if(cellType == CellType::Mine)
+        {
+            state->setCellType(result.finalPos, CellType::Exploded);
+            result.exploded = true;
+            break;
+        }
+
+        if(cellType == CellType::Stop)
+            break;
+
+        if(cellType == CellType::Gem)
+        {
+            state->setCellType(result.finalPos, CellType::Waiting);
+            result.gemCellIds.push_back(state->cellId(result.finalPos));
+            onGemPicked(result.finalPos.rowIndex, result.finalPos.columnIndex);
+        }
+    }
+
+    state->ballPos() = result.finalPos;
+
+    recordSessionEvent(SessionLog::EventKind::Move, InertiaUtility::directionIndex(direction));
+    journal().record(startCellId,
+                     state->cellId(result.finalPos),
+                     InertiaUtility::directionIndex(direction),
+                     result.gemCellIds,
+                     result.exploded);
+
+    return result;
 }
 
 void MoveHandler::onGemPicked(quint32 rowIndex, quint32 columnIndex)
 {
     --StateWrapper::instance().state()->remainingGemsCount();
-    std::erase(StateWrapper::instance().state()->gemsPositions(), Definitions::Position{rowIndex, columnIndex});
+    StateWrapper::instance().state()->gemIndex().remove(Definitions::Position{rowIndex, columnIndex});
 
     m_hintHandler->onGemPicked(rowIndex, columnIndex);
 }
+
+MoveJournal& MoveHandler::journal()
+{
+    if(const auto boardVersion {StateWrapper::instance().state()->boardVersion()}; !m_journal.isFor(boardVersion))
+        m_journal.reset(boardVersion);
+
+    return m_journal;
+}
+
+void MoveHandler::recordSessionEvent(SessionLog::EventKind kind, std::size_t directionIndex)
+{
+    if(m_sessionRecorder.isRecordingFor(StateWrapper::instance().state()->boardVersion()))
+        m_sessionRecorder.record(kind, directionIndex);
+}
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "movement-result.hpp"
+#include "movement-sequence-result.hpp"
 #include "common-definitions.hpp"
 #include "hint-handler.hpp"
+#include "move-journal.hpp"
+#include "session-log.hpp"
 
 
 class MoveHandler
@@ -12,12 +15,35 @@ public:
     MoveHandler();
 
     MovementResult moveBall(Definitions::MovementDirection direction);
+    MovementSequenceResult moveBallSequence(const QList<Definitions::MovementDirection>& directions);
     void undo(QPointF preMovePos, QList<QPointF> pickedGems);
-    void hint();
+    bool undoLastMove();
+    bool redoMove();
+    void restartGame();
+    bool canUndo() const;
+    bool canRedo() const;
+    void hint(const HintBudget& budget = {});
+    void precomputeHint(QObject* context);
+    void solve();
+
+    void startSessionRecording();
+    std::optional<SessionLog> stopSessionRecording();
 
 private:
 
+    struct SlideResult
+    {
+        Definitions::Position finalPos;
+        std::vector<quint32> gemCellIds;
+        bool exploded {false};
+    };
+
+    SlideResult slideBall(Definitions::MovementDirection direction);
     void onGemPicked(quint32 rowIndex, quint32 columnIndex);
+    MoveJournal& journal();
+    void recordSessionEvent(SessionLog::EventKind kind, std::size_t directionIndex = 0);
 
     std::unique_ptr<HintHandler> m_hintHandler{};
+    MoveJournal m_journal;
+    SessionRecorder m_sessionRecorder;
 };
@@ -0,0 +1,102 @@
+#include "move-journal.hpp"
+
+#include <algorithm>
+
+
+void MoveJournal::reset(quint64 boardVersion)
+{
+    m_first = m_cursor = m_last = 0;
+    m_gemsHead = 0;
+    m_boardVersion = boardVersion;
+}
+
+bool MoveJournal::isFor(quint64 boardVersion) const
+{
+    return m_boardVersion == boardVersion;
+}
+
+void MoveJournal::record(quint32 startCellId,
+                          quint32 endCellId,
+                          std::size_t directionIndex,
+                          std::span<const quint32> gemCellIds,
+                          bool explodedMine)
+{
+    if(gemCellIds.size() > kGemsArenaSize)
+    {
+        m_first = m_cursor = m_last;
+        return;
+    }
+
+    m_last = m_cursor;
+
+    if(m_cursor != m_first)
+    {
+        const auto& previous {recordAt(m_cursor - 1)};
+        m_gemsHead = previous.gemsOffset + previous.gemsCount;
+    }
+
+    if(m_gemsHead % kGemsArenaSize + gemCellIds.size() > kGemsArenaSize)
+        m_gemsHead += kGemsArenaSize - m_gemsHead % kGemsArenaSize;
+
+    const auto gemsEnd {m_gemsHead + gemCellIds.size()};
+
+    while(m_first != m_last &&
+           (m_last - m_first == kMaxRecordsCount || recordAt(m_first).gemsOffset + kGemsArenaSize < gemsEnd))
+        dropOldest();
+
+    std::copy(gemCellIds.begin(), gemCellIds.end(), m_gemsArena.begin() + m_gemsHead % kGemsArenaSize);
+
+    recordAt(m_last) = {startCellId,
+                        endCellId,
+                        m_gemsHead,
+                        static_cast<quint32>(gemCellIds.size()),
+                        static_cast<qint8>(directionIndex),
+                        explodedMine};
+
+    m_gemsHead = gemsEnd;
+    m_cursor = ++m_last;
+}
+
+std::optional<MoveJournal::Record> MoveJournal::undo()
+{
+    if(!canUndo())
+        return {};
+
+    return recordAt(--m_cursor);
+}
+
+std::optional<MoveJournal::Record> MoveJournal::redo()
+{
+    if(!canRedo())
+        return {};
+
+    return recordAt(m_cursor++);
+}
+
+std::span<const quint32> MoveJournal::gemCells(const Record& record) const
+{
+    const auto begin {m_gemsArena.data() + record.gemsOffset % kGemsArenaSize};
+
+    return {begin, begin + record.gemsCount};
+}
+
+bool MoveJournal::canUndo() const
+{
+    return m_cursor != m_first;
+}
+
+bool MoveJournal::canRedo() const
+{
+    return m_cursor != m_last;
+}
+
+MoveJournal::Record& MoveJournal::recordAt(quint64 sequence)
+{
+    return m_records[sequence % kMaxRecordsCount];
+}
+
+void MoveJournal::dropOldest()
+{
+    ++m_first;
+    m_cursor = std::max(m_cursor, m_first);
+}
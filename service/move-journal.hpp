@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <optional>
+#include <span>
+#include <vector>
+
+
+class MoveJournal
+{
+public:
+
+    struct Record
+    {
+        quint32 startCellId{};
+        quint32 endCellId{};
+        quint64 gemsOffset{};
+        quint32 gemsCount{};
+        qint8 directionIndex{};
+        bool explodedMine{false};
+    };
+
+    void reset(quint64 boardVersion);
+    bool isFor(quint64 boardVersion) const;
+
+    void record(quint32 startCellId,
+                 quint32 endCellId,
+                 std::size_t directionIndex,
+                 std::span<const quint32> gemCellIds,
+                 bool explodedMine);
+
+    std::optional<Record> undo();
+    std::optional<Record> redo();
+    std::span<const quint32> gemCells(const Record& record) const;
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+private:
+
+    Record& recordAt(quint64 sequence);
+    void dropOldest();
+
+    static inline constexpr quint64 kMaxRecordsCount = 1 << 14;
+    static inline constexpr quint64 kGemsArenaSize = 1 << 16;
+
+    std::vector<Record> m_records = std::vector<Record>(kMaxRecordsCount);
+    std::vector<quint32> m_gemsArena = std::vector<quint32>(kGemsArenaSize);
+    quint64 m_first{}, m_cursor{}, m_last{};
+    quint64 m_gemsHead{};
+    std::optional<quint64> m_boardVersion{};
+};
@@ -0,0 +1,162 @@
+#include "ready-level-queue.hpp"
+#include "engine-scheduler.hpp"
+#include "game-generator/game-generator.hpp"
+#include "state-wrapper.hpp"
+#include "utility.hpp"
+
+
+std::optional<SessionLog> ReadyLevelQueue::take(quint32 rowsCount,
+                                                quint32 columnsCount,
+                                                const QString& gamesDataFilesPath)
+{
+    std::optional<SessionLog> level;
+
+    {
+        std::scoped_lock lock{m_mutex};
+        auto& shelf {m_shelves[{rowsCount, columnsCount}]};
+
+        if(shelf.levels.size())
+        {
+            level = std::move(shelf.levels.front());
+            shelf.levels.pop_front();
+        }
+    }
+
+    refill(rowsCount, columnsCount, gamesDataFilesPath);
+
+    return level;
+}
+
+void ReadyLevelQueue::refill(quint32 rowsCount, quint32 columnsCount, const QString& gamesDataFilesPath)
+{
+    {
+        std::scoped_lock lock{m_mutex};
+        auto& shelf {m_shelves[{rowsCount, columnsCount}]};
+
+        if(shelf.refilling || shelf.levels.size() >= kCapacity)
+            return;
+
+        shelf.refilling = true;
+    }
+
+    EngineScheduler::instance().submit(TaskPriority::Background,
+                                       [self = shared_from_this(), rowsCount, columnsCount, gamesDataFilesPath]
+    {
+        self->fill(rowsCount, columnsCount, gamesDataFilesPath);
+    });
+}
+
+std::size_t ReadyLevelQueue::readyCount(quint32 rowsCount, quint32 columnsCount)
+{
+    std::scoped_lock lock{m_mutex};
+    return m_shelves[{rowsCount, columnsCount}].levels.size();
+}
+
+void ReadyLevelQueue::fill(quint32 rowsCount, quint32 columnsCount, const QString& gamesDataFilesPath)
+{
+    RefillingScope refilling{*this, rowsCount, columnsCount};
+    GameStateMaintainer state{false};
+    GameGenerator generator;
+
+    state.setGamesDataFilesPath(gamesDataFilesPath);
+    state.setRowsCount(rowsCount, false);
+    state.setColumnsCount(columnsCount, false);
+
+    const ThreadStateScope threadState {&state};
+
+    while(true)
+    {
+        auto level {generateLevel(generator, state)};
+
+        if(!level)
+            level = decodePackLevel(generator, state);
+
+        std::scoped_lock lock{m_mutex};
+        auto& shelf {m_shelves[{rowsCount, columnsCount}]};
+
+        if(level)
+            shelf.levels.push_back(std::move(level.value()));
+
+        if(!level || shelf.levels.size() >= kCapacity)
+        {
+            refilling.finish(shelf);
+            break;
+        }
+    }
+}
+
+std::optional<SessionLog> ReadyLevelQueue::generateLevel(GameGenerator& generator, GameStateMaintainer& state)
+{
+    generator.resetStopParam();
+
+    if(!generator.initializeModel())
+        return {};
+
+    SessionLog level;
+    level.captureLevel(state);
+
+    return level;
+}
+
+std::optional<SessionLog> ReadyLevelQueue::decodePackLevel(GameGenerator& generator, GameStateMaintainer& state)
+{
+    const auto rowsCount {state.rowsCount()};
+    const auto columnsCount {state.columnsCount()};
+    std::optional<QStringList> packEntries;
+
+    {
+        std::scoped_lock lock{m_mutex};
+        packEntries = m_shelves[{rowsCount, columnsCount}].packEntries;
+    }
+
+    if(!packEntries)
+    {
+        try
+        {
+            const auto filePath {state.pathForDimensions(rowsCount, columnsCount)};
+            packEntries = filePath.size() ? GameGenerator::packEntries(filePath) : QStringList{};
+        }
+
+        catch(const std::runtime_error&)
+        {
+            return {};
+        }
+
+        std::scoped_lock lock{m_mutex};
+        m_shelves[{rowsCount, columnsCount}].packEntries = packEntries;
+    }
+
+    if(packEntries->isEmpty())
+        return {};
+
+    auto& randomGenerator {InertiaUtility::randomEngine()};
+
+    generator.loadPackEntry(rowsCount, columnsCount, packEntries->at(randomGenerator() % packEntries->size()));
+
+    SessionLog level;
+    level.captureLevel(state);
+
+    return level;
+}
+
+ReadyLevelQueue::RefillingScope::RefillingScope(ReadyLevelQueue& queue, quint32 rowsCount, quint32 columnsCount) :
+    m_queue(queue),
+    m_boardSize(rowsCount, columnsCount)
+{
+
+}
+
+ReadyLevelQueue::RefillingScope::~RefillingScope()
+{
+    if(m_finished)
+        return;
+
+    std::scoped_lock lock{m_queue.m_mutex};
+    finish(m_queue.m_shelves[m_boardSize]);
+}
+
+void ReadyLevelQueue::RefillingScope::finish(Shelf& shelf)
+{
+    shelf.refilling = false;
+    m_finished = true;
+}
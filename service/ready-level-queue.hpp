@@ -0,0 +1,62 @@
+#pragma once
+
+#include "session-log.hpp"
+
+#include <QStringList>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+
+class GameGenerator;
+class GameStateMaintainer;
+
+
+class ReadyLevelQueue : public std::enable_shared_from_this<ReadyLevelQueue>
+{
+public:
+
+    std::optional<SessionLog> take(quint32 rowsCount, quint32 columnsCount, const QString& gamesDataFilesPath);
+    void refill(quint32 rowsCount, quint32 columnsCount, const QString& gamesDataFilesPath);
+    std::size_t readyCount(quint32 rowsCount, quint32 columnsCount);
+
+    static inline constexpr std::size_t kCapacity {4};
+
+private:
+
+    struct Shelf
+    {
+        std::deque<SessionLog> levels;
+        std::optional<QStringList> packEntries;
+        bool refilling{false};
+    };
+
+    class RefillingScope
+    {
+    public:
+
+        RefillingScope(ReadyLevelQueue& queue, quint32 rowsCount, quint32 columnsCount);
+        ~RefillingScope();
+
+        RefillingScope(const RefillingScope&) = delete;
+        RefillingScope& operator=(const RefillingScope&) = delete;
+
+        void finish(Shelf& shelf);
+
+    private:
+
+        ReadyLevelQueue& m_queue;
+        std::pair<quint32, quint32> m_boardSize;
+        bool m_finished{false};
+    };
+
+    void fill(quint32 rowsCount, quint32 columnsCount, const QString& gamesDataFilesPath);
+    std::optional<SessionLog> generateLevel(GameGenerator& generator, GameStateMaintainer& state);
+    std::optional<SessionLog> decodePackLevel(GameGenerator& generator, GameStateMaintainer& state);
+
+    std::mutex m_mutex;
+    std::map<std::pair<quint32, quint32>, Shelf> m_shelves;
+};
@@ -0,0 +1,263 @@
+#include "session-log.hpp"
+#include "game-state-maintainer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+
+namespace
+{
+    template<typename T>
+    void appendValue(QByteArray& data, T value)
+    {
+        for(std::size_t i{}; i < sizeof(T); ++i)
+            data.append(static_cast<char>((static_cast<quint64>(value) >> (8 * i)) & 0xFF));
+    }
+
+    template<typename T>
+    bool readValue(const QByteArray& data, qsizetype& offset, T& value)
+    {
+        if(offset + static_cast<qsizetype>(sizeof(T)) > data.size())
+            return false;
+
+        quint64 result{};
+
+        for(std::size_t i{}; i < sizeof(T); ++i)
+            result |= static_cast<quint64>(static_cast<quint8>(data[offset++])) << (8 * i);
+
+        value = static_cast<T>(result);
+
+        return true;
+    }
+
+    template<typename T>
+    void appendVector(QByteArray& data, const std::vector<T>& values)
+    {
+        appendValue<quint64>(data, values.size());
+
+        for(const auto value : values)
+            appendValue(data, value);
+    }
+
+    template<typename T>
+    bool readVector(const QByteArray& data, qsizetype& offset, std::vector<T>& values)
+    {
+        quint64 size{};
+
+        if(!readValue(data, offset, size) || size > static_cast<quint64>(data.size() - offset) / sizeof(T))
+            return false;
+
+        values.resize(size);
+
+        for(auto& value : values)
+            readValue(data, offset, value);
+
+        return true;
+    }
+}
+
+
+void SessionLog::captureLevel(const GameStateMaintainer& state)
+{
+    m_rowsCount = state.rowsCount();
+    m_columnsCount = state.columnsCount();
+    m_ballCellId = state.cellId(state.ballPos());
+    m_cells.clear();
+    m_cells.reserve(m_rowsCount * m_columnsCount);
+
+    for(const auto& row : state.cells())
+        for(const auto cellType : row)
+            m_cells.push_back(static_cast<quint8>(cellType));
+
+    m_stuckAreaCells.clear();
+
+    for(const auto& pos : state.stuckArea())
+        m_stuckAreaCells.push_back(state.cellId(pos));
+
+    std::sort(m_stuckAreaCells.begin(), m_stuckAreaCells.end());
+    m_stuckAreaGemCells.clear();
+
+    for(const auto& pos : state.stuckAreaGems())
+        m_stuckAreaGemCells.push_back(state.cellId(pos));
+}
+
+void SessionLog::applyLevel(GameStateMaintainer& state) const
+{
+    state.setRowsCount(m_rowsCount, false);
+    state.setColumnsCount(m_columnsCount, false);
+    state.resetCells();
+    state.stuckArea().clear();
+    state.stuckAreaGems().clear();
+    state.remainingGemsCount() = 0;
+
+    for(quint32 cellId{}; cellId < m_cells.size(); ++cellId)
+    {
+        const auto pos {state.cellPosition(cellId)};
+        const auto cellType {static_cast<Definitions::CellType>(m_cells[cellId])};
+        state.cellAt(pos.rowIndex, pos.columnIndex) = cellType;
+
+        if(cellType == Definitions::CellType::Gem)
+        {
+            state.gemIndex().add(pos);
+            ++state.remainingGemsCount();
+        }
+    }
+
+    state.initialCells() = state.cells();
+    state.gemsCount() = state.remainingGemsCount();
+    state.ballPos() = state.initialBallPos() = state.cellPosition(m_ballCellId);
+
+    for(const auto cellId : m_stuckAreaCells)
+        state.stuckArea().insert(state.cellPosition(cellId));
+
+    for(const auto cellId : m_stuckAreaGemCells)
+        state.stuckAreaGems().push_back(state.cellPosition(cellId));
+
+    state.findHintCandidateGems();
+    state.onGameStart() = true;
+    state.publishBoard();
+}
+
+quint64 SessionLog::levelId() const
+{
+    quint64 hash {0xCBF29CE484222325};
+
+    const auto mix {[&hash](quint64 value)
+        {
+            hash ^= value;
+            hash *= 0x100000001B3;
+        }};
+
+    mix(m_rowsCount);
+    mix(m_columnsCount);
+    mix(m_ballCellId);
+
+    for(const auto cellType : m_cells)
+        mix(cellType);
+
+    for(const auto cellId : m_stuckAreaCells)
+        mix(cellId);
+
+    for(const auto cellId : m_stuckAreaGemCells)
+        mix(cellId);
+
+    return hash;
+}
+
+void SessionLog::append(const Event& event)
+{
+    const auto bitIndex {m_eventsCount * kDirectionBits};
+
+    if((bitIndex + kDirectionBits + 7) / 8 > m_directionBits.size())
+        m_directionBits.push_back(0);
+
+    const auto direction {static_cast<quint32>(event.directionIndex & 0x7) << (bitIndex % 8)};
+    m_directionBits[bitIndex / 8] |= direction & 0xFF;
+
+    if(direction >> 8)
+        m_directionBits[bitIndex / 8 + 1] |= direction >> 8;
+
+    for(auto timing {static_cast<quint64>(event.elapsedMs) << 2 | static_cast<quint8>(event.kind)}; ; timing >>= 7)
+    {
+        if(timing < 0x80)
+        {
+            m_timings.push_back(timing);
+            break;
+        }
+
+        m_timings.push_back((timing & 0x7F) | 0x80);
+    }
+
+    ++m_eventsCount;
+}
+
+quint64 SessionLog::eventsCount() const
+{
+    return m_eventsCount;
+}
+
+QByteArray SessionLog::serialize() const
+{
+    QByteArray data;
+
+    appendValue(data, kMagic);
+    appendValue(data, kFormatVersion);
+    appendValue(data, levelId());
+    appendValue(data, m_rowsCount);
+    appendValue(data, m_columnsCount);
+    appendValue(data, m_ballCellId);
+    appendVector(data, m_cells);
+    appendVector(data, m_stuckAreaCells);
+    appendVector(data, m_stuckAreaGemCells);
+    appendValue(data, m_eventsCount);
+    appendVector(data, m_directionBits);
+    appendVector(data, m_timings);
+
+    return data;
+}
+
+std::optional<SessionLog> SessionLog::deserialize(const QByteArray& data)
+{
+    SessionLog log;
+    qsizetype offset{};
+    quint32 magic{};
+    quint8 formatVersion{};
+    quint64 levelId{};
+
+    if(!readValue(data, offset, magic) || magic != kMagic ||
+        !readValue(data, offset, formatVersion) || formatVersion != kFormatVersion ||
+        !readValue(data, offset, levelId) ||
+        !readValue(data, offset, log.m_rowsCount) ||
+        !readValue(data, offset, log.m_columnsCount) ||
+        !readValue(data, offset, log.m_ballCellId) ||
+        !readVector(data, offset, log.m_cells) ||
+        !readVector(data, offset, log.m_stuckAreaCells) ||
+        !readVector(data, offset, log.m_stuckAreaGemCells) ||
+        !readValue(data, offset, log.m_eventsCount) ||
+        !readVector(data, offset, log.m_directionBits) ||
+        !readVector(data, offset, log.m_timings))
+        return {};
+
+    const auto cellsCount {static_cast<quint64>(log.m_rowsCount) * log.m_columnsCount};
+
+    if(log.m_cells.size() != cellsCount || (cellsCount && log.m_ballCellId >= cellsCount) ||
+        log.m_directionBits.size() != (log.m_eventsCount * kDirectionBits + 7) / 8 ||
+        log.levelId() != levelId)
+        return {};
+
+    if(std::count_if(log.m_timings.cbegin(), log.m_timings.cend(), [](quint8 byte) { return !(byte & 0x80); }) !=
+        static_cast<qint64>(log.m_eventsCount))
+        return {};
+
+    return log;
+}
+
+void SessionRecorder::start(const GameStateMaintainer& state)
+{
+    m_log.emplace();
+    m_log->captureLevel(state);
+    m_boardVersion = state.boardVersion();
+    m_lastEventTime = std::chrono::steady_clock::now();
+}
+
+std::optional<SessionLog> SessionRecorder::stop()
+{
+    return std::exchange(m_log, std::nullopt);
+}
+
+bool SessionRecorder::isRecordingFor(quint64 boardVersion) const
+{
+    return m_log && m_boardVersion == boardVersion;
+}
+
+void SessionRecorder::record(SessionLog::EventKind kind, std::size_t directionIndex)
+{
+    const auto now {std::chrono::steady_clock::now()};
+    const auto elapsedMs {std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastEventTime).count()};
+
+    m_lastEventTime = now;
+    m_log->append({kind,
+                   static_cast<quint8>(directionIndex),
+                   static_cast<quint32>(std::min<qint64>(elapsedMs, std::numeric_limits<quint32>::max()))});
+}
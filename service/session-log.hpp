@@ -0,0 +1,115 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <QByteArray>
+
+#include <chrono>
+#include <optional>
+#include <vector>
+
+
+class GameStateMaintainer;
+
+
+class SessionLog
+{
+public:
+
+    enum class EventKind : quint8
+    {
+        Move,
+        Undo,
+        Hint
+    };
+
+    struct Event
+    {
+        EventKind kind {EventKind::Move};
+        quint8 directionIndex{};
+        quint32 elapsedMs{};
+    };
+
+    void captureLevel(const GameStateMaintainer& state);
+    void applyLevel(GameStateMaintainer& state) const;
+    quint64 levelId() const;
+
+    void append(const Event& event);
+    quint64 eventsCount() const;
+
+    template<typename Callback>
+    bool forEachEvent(Callback&& callback) const;
+
+    QByteArray serialize() const;
+    static std::optional<SessionLog> deserialize(const QByteArray& data);
+
+private:
+
+    static inline constexpr quint32 kMagic = 0x4C534E49;
+    static inline constexpr quint8 kFormatVersion = 1;
+    static inline constexpr quint8 kDirectionBits = 3;
+    static inline constexpr quint8 kMaxVarintLength = 10;
+
+    quint16 m_rowsCount{}, m_columnsCount{};
+    quint32 m_ballCellId{};
+    std::vector<quint8> m_cells;
+    std::vector<quint32> m_stuckAreaCells;
+    std::vector<quint32> m_stuckAreaGemCells;
+
+    quint64 m_eventsCount{};
+    std::vector<quint8> m_directionBits;
+    std::vector<quint8> m_timings;
+};
+
+
+class SessionRecorder
+{
+public:
+
+    void start(const GameStateMaintainer& state);
+    std::optional<SessionLog> stop();
+    bool isRecordingFor(quint64 boardVersion) const;
+
+    void record(SessionLog::EventKind kind, std::size_t directionIndex = 0);
+
+private:
+
+    std::optional<SessionLog> m_log{};
+    quint64 m_boardVersion{};
+    std::chrono::steady_clock::time_point m_lastEventTime{};
+};
+
+
+template<typename Callback>
+bool SessionLog::forEachEvent(Callback&& callback) const
+{
+    std::size_t timingsIndex{};
+
+    for(quint64 i{}; i < m_eventsCount; ++i)
+    {
+        const auto bitIndex {i * kDirectionBits};
+        const quint32 window {static_cast<quint32>(m_directionBits[bitIndex / 8]) |
+                              (bitIndex / 8 + 1 < m_directionBits.size() ? static_cast<quint32>(m_directionBits[bitIndex / 8 + 1]) << 8 : 0u)};
+
+        quint64 timing{};
+
+        for(quint8 length{}; ; ++length)
+        {
+            if(length == kMaxVarintLength)
+                return false;
+
+            const auto byte {m_timings[timingsIndex++]};
+            timing |= static_cast<quint64>(byte & 0x7F) << (length * 7);
+
+            if(!(byte & 0x80))
+                break;
+        }
+
+        if(!callback(Event{static_cast<EventKind>(timing & 0x3),
+                           static_cast<quint8>((window >> (bitIndex % 8)) & 0x7),
+                           static_cast<quint32>(timing >> 2)}))
+            return false;
+    }
+
+    return true;
+}
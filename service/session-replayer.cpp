@@ -0,0 +1,57 @@
+#include "session-replayer.hpp"
+#include "game-state-maintainer.hpp"
+#include "move-handler.hpp"
+#include "constants.hpp"
+
+
+std::optional<ReplaySummary> SessionReplayer::replay(const SessionLog& log, GameStateMaintainer& state, MoveHandler& moveHandler)
+{
+    ReplaySummary summary;
+    summary.traceHash = 0xCBF29CE484222325;
+
+    log.applyLevel(state);
+
+    const auto replayed {log.forEachEvent([&](const SessionLog::Event& event)
+        {
+            switch(event.kind)
+            {
+            case SessionLog::EventKind::Move:
+            {
+                const auto result {moveHandler.moveBall(Constants::kAllDirections[event.directionIndex])};
+                const auto& finalPos {result.finalDestination()};
+
+                if(state.cellAt(finalPos.y(), finalPos.x()) == Definitions::CellType::Exploded)
+                    ++summary.explosionsCount;
+
+                ++summary.movesCount;
+                break;
+            }
+
+            case SessionLog::EventKind::Undo:
+                moveHandler.undoLastMove();
+                ++summary.undosCount;
+                break;
+
+            case SessionLog::EventKind::Hint:
+                moveHandler.hint();
+                ++summary.hintsCount;
+                break;
+
+            default:
+                return false;
+            }
+
+            summary.traceHash ^= static_cast<quint64>(state.cellId(state.ballPos())) << 32 | state.remainingGemsCount();
+            summary.traceHash *= 0x100000001B3;
+
+            return true;
+        })};
+
+    if(!replayed)
+        return {};
+
+    summary.remainingGemsCount = state.remainingGemsCount();
+    summary.finalBallCellId = state.cellId(state.ballPos());
+
+    return summary;
+}
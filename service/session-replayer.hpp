@@ -0,0 +1,29 @@
+#pragma once
+
+#include "session-log.hpp"
+
+#include <optional>
+
+
+class GameStateMaintainer;
+class MoveHandler;
+
+
+struct ReplaySummary
+{
+    quint64 movesCount{};
+    quint64 undosCount{};
+    quint64 hintsCount{};
+    quint64 explosionsCount{};
+    quint32 remainingGemsCount{};
+    quint32 finalBallCellId{};
+    quint64 traceHash{};
+};
+
+
+class SessionReplayer
+{
+public:
+
+    static std::optional<ReplaySummary> replay(const SessionLog& log, GameStateMaintainer& state, MoveHandler& moveHandler);
+};
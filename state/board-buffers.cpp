@@ -0,0 +1,61 @@
+#include "board-buffers.hpp"
+
+
+BoardBuffers::BoardBuffers() : m_front(&m_buffers[0]), m_back(&m_buffers[1])
+{
+
+}
+
+const BoardBuffer& BoardBuffers::front() const
+{
+    return *m_front.load(std::memory_order_acquire);
+}
+
+void BoardBuffers::fillBack(const std::vector<std::vector<Definitions::CellType>>& cells,
+                            quint32 rowsCount,
+                            quint32 columnsCount)
+{
+    std::scoped_lock lock{m_backMutex};
+
+    m_back->rowsCount = rowsCount;
+    m_back->columnsCount = columnsCount;
+    m_back->cells.resize(rowsCount * columnsCount);
+
+    auto cellsData {m_back->cells.data()};
+
+    for(quint32 rowIndex{}; rowIndex < rowsCount; ++rowIndex)
+        for(quint32 columnIndex{}; columnIndex < columnsCount; ++columnIndex)
+            *cellsData++ = static_cast<char>(cells[rowIndex][columnIndex]);
+
+    m_backFilled = true;
+}
+
+bool BoardBuffers::publish()
+{
+    std::scoped_lock lock{m_backMutex};
+
+    if(!m_backFilled)
+        return false;
+
+    m_backFilled = false;
+    m_back = m_front.exchange(m_back, std::memory_order_acq_rel);
+
+    return true;
+}
+
+bool BoardBuffers::updateFront(const std::vector<std::vector<Definitions::CellType>>& cells, const CellRect& rect)
+{
+    auto& front {*m_front.load(std::memory_order_relaxed)};
+
+    if(rect.bottomRowIndex >= front.rowsCount || rect.rightColumnIndex >= front.columnsCount ||
+        rect.bottomRowIndex >= cells.size() || rect.rightColumnIndex >= cells[rect.bottomRowIndex].size())
+        return false;
+
+    auto cellsData {front.cells.data()};
+
+    for(auto rowIndex {rect.topRowIndex}; rowIndex <= rect.bottomRowIndex; ++rowIndex)
+        for(auto columnIndex {rect.leftColumnIndex}; columnIndex <= rect.rightColumnIndex; ++columnIndex)
+            cellsData[rowIndex * front.columnsCount + columnIndex] = static_cast<char>(cells[rowIndex][columnIndex]);
+
+    return true;
+}
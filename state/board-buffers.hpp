@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common-definitions.hpp"
+#include "cell-change-tracker.hpp"
+
+#include <QByteArray>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+
+struct BoardBuffer
+{
+    quint32 rowsCount{};
+    quint32 columnsCount{};
+    QByteArray cells;
+};
+
+
+class BoardBuffers
+{
+public:
+
+    BoardBuffers();
+
+    BoardBuffers(const BoardBuffers&) = delete;
+    BoardBuffers& operator=(const BoardBuffers&) = delete;
+
+    const BoardBuffer& front() const;
+    void fillBack(const std::vector<std::vector<Definitions::CellType>>& cells,
+                  quint32 rowsCount,
+                  quint32 columnsCount);
+    bool publish();
+    bool updateFront(const std::vector<std::vector<Definitions::CellType>>& cells, const CellRect& rect);
+
+private:
+
+    std::array<BoardBuffer, 2> m_buffers;
+    std::atomic<BoardBuffer*> m_front;
+    BoardBuffer* m_back{};
+    bool m_backFilled{false};
+    std::mutex m_backMutex;
+};
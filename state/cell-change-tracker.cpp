@@ -0,0 +1,104 @@
+#include "cell-change-tracker.hpp"
+
+#include <algorithm>
+
+
+void CellChangeTracker::reset(quint32 rowsCount, quint32 columnsCount)
+{
+    m_columnsCount = columnsCount;
+    m_marked.assign(rowsCount * columnsCount, false);
+    m_cells.clear();
+}
+
+void CellChangeTracker::mark(const Definitions::Position& pos)
+{
+    const auto cellId {pos.rowIndex * m_columnsCount + pos.columnIndex};
+
+    if(cellId >= m_marked.size() || m_marked[cellId])
+        return;
+
+    m_marked[cellId] = true;
+    m_cells.push_back(cellId);
+}
+
+void CellChangeTracker::clear()
+{
+    for(const auto cellId : m_cells)
+        m_marked[cellId] = false;
+
+    m_cells.clear();
+}
+
+bool CellChangeTracker::isEmpty() const
+{
+    return m_cells.empty();
+}
+
+std::span<const quint32> CellChangeTracker::cells() const
+{
+    return m_cells;
+}
+
+std::vector<CellRect> CellChangeTracker::rects() const
+{
+    auto sortedCells {m_cells};
+    std::sort(sortedCells.begin(), sortedCells.end());
+
+    std::vector<CellRect> rowSpans;
+
+    for(const auto cellId : sortedCells)
+    {
+        const auto rowIndex {cellId / m_columnsCount};
+        const auto columnIndex {cellId % m_columnsCount};
+
+        if(rowSpans.size() && rowSpans.back().topRowIndex == rowIndex && rowSpans.back().rightColumnIndex + 1 == columnIndex)
+            rowSpans.back().rightColumnIndex = columnIndex;
+
+        else
+            rowSpans.push_back({rowIndex, columnIndex, rowIndex, columnIndex});
+    }
+
+    std::vector<CellRect> result;
+    std::vector<std::size_t> openRects;
+    std::vector<std::size_t> nextOpenRects;
+
+    for(std::size_t begin{}; begin < rowSpans.size(); )
+    {
+        const auto rowIndex {rowSpans[begin].topRowIndex};
+        auto end {begin};
+
+        while(end < rowSpans.size() && rowSpans[end].topRowIndex == rowIndex)
+            ++end;
+
+        nextOpenRects.clear();
+        auto openIt {openRects.cbegin()};
+
+        for(auto i {begin}; i < end; ++i)
+        {
+            const auto& span {rowSpans[i]};
+
+            while(openIt != openRects.cend() && result[*openIt].leftColumnIndex < span.leftColumnIndex)
+                ++openIt;
+
+            if(openIt != openRects.cend() &&
+                result[*openIt].bottomRowIndex + 1 == rowIndex &&
+                result[*openIt].leftColumnIndex == span.leftColumnIndex &&
+                result[*openIt].rightColumnIndex == span.rightColumnIndex)
+            {
+                result[*openIt].bottomRowIndex = rowIndex;
+                nextOpenRects.push_back(*openIt);
+            }
+
+            else
+            {
+                result.push_back(span);
+                nextOpenRects.push_back(result.size() - 1);
+            }
+        }
+
+        openRects.swap(nextOpenRects);
+        begin = end;
+    }
+
+    return result;
+}
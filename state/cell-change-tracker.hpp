@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <span>
+#include <vector>
+
+
+struct CellRect
+{
+    quint32 topRowIndex{};
+    quint32 leftColumnIndex{};
+    quint32 bottomRowIndex{};
+    quint32 rightColumnIndex{};
+};
+
+
+class CellChangeTracker
+{
+public:
+
+    void reset(quint32 rowsCount, quint32 columnsCount);
+    void mark(const Definitions::Position& pos);
+    void clear();
+
+    bool isEmpty() const;
+    std::span<const quint32> cells() const;
+    std::vector<CellRect> rects() const;
+
+private:
+
+    quint32 m_columnsCount{};
+    std::vector<bool> m_marked;
+    std::vector<quint32> m_cells;
+};
@@ -1,25 +1,31 @@
 #include "constants.hpp"
 #include "utility.hpp"
 #include "state-wrapper.hpp"
+#include "service/engine-trace.hpp"
 
 #include <QFile>
+#include <QThread>
 
-#include <execution>
 
+GameStateMaintainer::GameStateMaintainer(QObject* parent) : GameStateMaintainer(true, parent)
+{
+
+}
 
-GameStateMaintainer::GameStateMaintainer(QObject* parent) : QObject(parent)
+GameStateMaintainer::GameStateMaintainer(bool registerAsEngineState, QObject* parent) : QObject(parent)
 {
-    StateWrapper::instance().setState(this);
+    if(registerAsEngineState)
+        StateWrapper::instance().setState(this);
 }
 
-InertiaModel* GameStateMaintainer::model() const
+QObject* GameStateMaintainer::model() const
 {
-    return m_gameModel;
+    return dynamic_cast<QObject*>(m_observer);
 }
 
-void GameStateMaintainer::setModel(InertiaModel* model)
+void GameStateMaintainer::setModel(QObject* model)
 {
-    m_gameModel = model;
+    m_observer = dynamic_cast<StateObserver*>(model);
 }
 
 std::vector<std::vector<Definitions::CellType>>& GameStateMaintainer::cells()
@@ -45,6 +51,13 @@ const Definitions::CellType& GameStateMaintainer::cellAt(quint32 rowIndex, quint
     return m_cells[rowIndex][columnIndex];
 }
 
+void GameStateMaintainer::setCellType(const Definitions::Position& pos, Definitions::CellType cellType)
+{
+    m_cells[pos.rowIndex][pos.columnIndex] = cellType;
+    m_changedSinceLoad.mark(pos);
+    queueCellChange(pos);
+}
+
 std::vector<std::vector<Definitions::CellType>>& GameStateMaintainer::initialCells()
 {
     return m_initialCells;
@@ -66,8 +79,8 @@ void GameStateMaintainer::setRowsCount(quint32 newRowsCount, bool emitSignal)
     {
         m_rowsCount = newRowsCount;
 
-        if(emitSignal)
-            static_cast<InertiaModel*>(m_gameModel)->notifyRowsCountChange(newRowsCount);
+        if(emitSignal && m_observer)
+            m_observer->notifyRowsCountChange(newRowsCount);
     }
 }
 
@@ -82,28 +95,19 @@ void GameStateMaintainer::setColumnsCount(quint32 columnsCount, bool emitSignal)
     {
         m_columnsCount = columnsCount;
 
-        if(emitSignal)
-            static_cast<InertiaModel*>(m_gameModel)->notifyColumnsCountChange(columnsCount);
+        if(emitSignal && m_observer)
+            m_observer->notifyColumnsCountChange(columnsCount);
     }
 }
 
-QModelIndex GameStateMaintainer::index(quint32 rowIndex, quint32 columnIndex)
+quint32 GameStateMaintainer::cellId(const Definitions::Position& pos) const
 {
-    return m_gameModel->index(rowIndex, columnIndex);
+    return pos.rowIndex * m_columnsCount + pos.columnIndex;
 }
 
-QVariant GameStateMaintainer::data(const QModelIndex& index, int role) const
+Definitions::Position GameStateMaintainer::cellPosition(quint32 cellId) const
 {
-    int rowIndex = index.row();
-    int columnIndex = index.column();
-
-    if(rowIndex < 0 || rowIndex >= m_rowsCount || columnIndex < 0 || columnIndex >= m_columnsCount)
-        return QVariant();
-
-    if(role == Qt::DisplayRole)
-        return m_cells[rowIndex][columnIndex];
-
-    return {};
+    return Definitions::Position{cellId / m_columnsCount, cellId % m_columnsCount};
 }
 
 void GameStateMaintainer::resetGameData(quint32 rowsCount, quint32 columnsCount)
@@ -114,24 +118,176 @@ void GameStateMaintainer::resetGameData(quint32 rowsCount, quint32 columnsCount)
     m_remainingGemsCount = 0;
 }
 
-void GameStateMaintainer::notifyDataChange(const QModelIndex& topLeft, const QModelIndex& downRight) const
+void GameStateMaintainer::notifyBoardDataChange() const
+{
+    if(m_observer)
+        m_observer->notifyBoardDataChange(boardDataVersion());
+}
+
+void GameStateMaintainer::beginCellChanges()
+{
+    std::scoped_lock lock{m_cellChangesMutex};
+    ++m_cellChangesDepth;
+}
+
+void GameStateMaintainer::endCellChanges()
+{
+    {
+        std::scoped_lock lock{m_cellChangesMutex};
+
+        if(--m_cellChangesDepth)
+            return;
+
+        if(QThread::currentThread() != thread())
+        {
+            if(!m_cellChangesFlushQueued && !m_pendingCellChanges.isEmpty())
+            {
+                m_cellChangesFlushQueued = true;
+                QMetaObject::invokeMethod(this, &GameStateMaintainer::flushCellChanges, Qt::QueuedConnection);
+            }
+
+            return;
+        }
+    }
+
+    flushCellChanges();
+}
+
+void GameStateMaintainer::flushCellChanges()
+{
+    std::vector<CellRect> rects;
+
+    {
+        std::scoped_lock lock{m_cellChangesMutex};
+
+        m_cellChangesFlushQueued = false;
+
+        if(m_cellChangesDepth || m_pendingCellChanges.isEmpty())
+            return;
+
+        rects = m_pendingCellChanges.rects();
+        m_pendingCellChanges.clear();
+
+        m_boardDataHistory.push_back(rects);
+        ++m_boardDataVersion;
+
+        if(m_boardDataHistory.size() > kBoardDataHistoryLength)
+            m_boardDataHistory.pop_front();
+    }
+
+    for(const auto& rect : rects)
+        if(m_boardBuffers.updateFront(m_cells, rect) && m_observer)
+            m_observer->notifyCellsChange(rect);
+
+    notifyBoardDataChange();
+}
+
+void GameStateMaintainer::queueCellChange(const Definitions::Position& pos)
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyDataChange(topLeft, downRight);
+    if(!m_observer)
+        return;
+
+    std::scoped_lock lock{m_cellChangesMutex};
+
+    m_pendingCellChanges.mark(pos);
+
+    if(m_cellChangesDepth || m_cellChangesFlushQueued)
+        return;
+
+    m_cellChangesFlushQueued = true;
+    QMetaObject::invokeMethod(this, &GameStateMaintainer::flushCellChanges, Qt::QueuedConnection);
 }
 
-void GameStateMaintainer::beginResetModel()
+void GameStateMaintainer::publishBoard()
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyDataModificationStart();
+    trackChangesSinceLoad();
+    ++m_boardVersion;
+    m_boardBuffers.fillBack(m_cells, m_rowsCount, m_columnsCount);
+
+    if(!m_observer || QThread::currentThread() == thread())
+        swapBoardBuffers();
+
+    else if(!m_boardSwapQueued.exchange(true))
+        QMetaObject::invokeMethod(this, &GameStateMaintainer::swapBoardBuffers, Qt::QueuedConnection);
 }
 
-void GameStateMaintainer::endResetModel()
+void GameStateMaintainer::swapBoardBuffers()
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyDataModificationEnd();
+    INERTIA_TRACE_SCOPE("swapBoardBuffers");
+
+    m_boardSwapQueued = false;
+
+    const auto previousRowsCount {m_boardBuffers.front().rowsCount};
+    const auto previousColumnsCount {m_boardBuffers.front().columnsCount};
+
+    if(m_observer)
+        m_observer->notifyDataModificationStart();
+
+    m_boardBuffers.publish();
+    invalidateBoardData();
+
+    if(!m_observer)
+        return;
+
+    m_observer->notifyDataModificationEnd();
+
+    const auto& board {m_boardBuffers.front()};
+
+    if(board.rowsCount != previousRowsCount)
+        m_observer->notifyRowsCountChange(board.rowsCount);
+
+    if(board.columnsCount != previousColumnsCount)
+        m_observer->notifyColumnsCountChange(board.columnsCount);
+}
+
+const BoardBuffer& GameStateMaintainer::publishedBoard() const
+{
+    return m_boardBuffers.front();
+}
+
+quint64 GameStateMaintainer::boardVersion() const
+{
+    return m_boardVersion.load();
+}
+
+quint64 GameStateMaintainer::boardDataVersion() const
+{
+    std::scoped_lock lock{m_cellChangesMutex};
+    return m_boardDataVersion;
+}
+
+BoardData GameStateMaintainer::boardData(quint64 sinceVersion)
+{
+    flushCellChanges();
+
+    std::scoped_lock lock{m_cellChangesMutex};
+
+    const auto& board {m_boardBuffers.front()};
+    const auto historyStartVersion {m_boardDataVersion - m_boardDataHistory.size()};
+
+    if(sinceVersion < historyStartVersion || sinceVersion > m_boardDataVersion)
+        return {board.cells, board.rowsCount, board.columnsCount, m_boardDataVersion, true,
+                {QRect(0, 0, board.columnsCount, board.rowsCount)}};
+
+    QList<QRect> changedRanges;
+
+    for(auto version {sinceVersion}; version < m_boardDataVersion; ++version)
+        for(const auto& rect : m_boardDataHistory[version - historyStartVersion])
+            changedRanges.push_back(QRect(rect.leftColumnIndex,
+                                          rect.topRowIndex,
+                                          rect.rightColumnIndex - rect.leftColumnIndex + 1,
+                                          rect.bottomRowIndex - rect.topRowIndex + 1));
+
+    return {board.cells, board.rowsCount, board.columnsCount, m_boardDataVersion, false, std::move(changedRanges)};
 }
 
 void GameStateMaintainer::notifyGameGenerationCompletion(quint64 gamesGenerated)
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyGameGenerationCompletion(gamesGenerated);
+    if(m_observer)
+        m_observer->notifyGameGenerationCompletion(gamesGenerated);
+
+    else
+        m_pendingGamesGenerated = gamesGenerated;
 }
 
 quint32& GameStateMaintainer::gemsCount()
@@ -182,22 +338,29 @@ void GameStateMaintainer::setBallPosition(QPointF pos)
 
 void GameStateMaintainer::notifyBallPosChange(const Definitions::Position& ballPos)
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyBallPosChange(ballPos);
+    if(m_observer)
+        m_observer->notifyBallPosChange(ballPos);
 }
 
 void GameStateMaintainer::notifyBallPosChange(const QPointF& ballPos)
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyBallPosChange(ballPos);
+    if(m_observer)
+        m_observer->notifyBallPosChange(Definitions::Position(ballPos.y(), ballPos.x()));
+}
+
+GemIndex& GameStateMaintainer::gemIndex()
+{
+    return m_gemIndex;
 }
 
-std::vector<Definitions::Position>& GameStateMaintainer::gemsPositions()
+const GemIndex& GameStateMaintainer::gemIndex() const
 {
-    return m_gemsPositions;
+    return m_gemIndex;
 }
 
 const std::vector<Definitions::Position>& GameStateMaintainer::gemsPositions() const
 {
-    return m_gemsPositions;
+    return m_gemIndex.positions();
 }
 
 quint32& GameStateMaintainer::remainingGemsCount()
@@ -212,12 +375,20 @@ const quint32& GameStateMaintainer::remainingGemsCount() const
 
 void GameStateMaintainer::notifyGameCompletion()
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyGameCompletion();
+    if(m_observer)
+        m_observer->notifyGameCompletion();
 }
 
-void GameStateMaintainer::showHint(Definitions::MovementDirection moveDir)
+void GameStateMaintainer::notifySolution(const std::vector<Definitions::MovementDirection>& moves)
 {
-    static_cast<InertiaModel*>(m_gameModel)->notifyHint(moveDir);
+    if(m_observer)
+        m_observer->notifySolution(QList<Definitions::MovementDirection>(moves.cbegin(), moves.cend()));
+}
+
+void GameStateMaintainer::showHint(Definitions::MovementDirection moveDir, bool optimal)
+{
+    if(m_observer)
+        m_observer->notifyHint(moveDir, optimal);
 }
 
 std::unordered_set<Definitions::Position>& GameStateMaintainer::stuckArea()
@@ -524,12 +695,8 @@ void GameStateMaintainer::announceBallPosition(QPointF ballPos)
     const auto rowIndex {ballPos.y()};
     const auto columnIndex {ballPos.x()};
 
-    if(auto& cellType {m_cells[rowIndex][columnIndex]}; cellType == Definitions::CellType::Waiting)
-    {
-        cellType = Definitions::CellType::Clear;
-        const auto cellIndex {index(rowIndex, columnIndex)};
-        static_cast<InertiaModel*>(m_gameModel)->notifyDataChange(cellIndex, cellIndex);
-    }
+    if(m_cells[rowIndex][columnIndex] == Definitions::CellType::Waiting)
+        setCellType(Definitions::Position(rowIndex, columnIndex), Definitions::CellType::Clear);
 }
 
 bool GameStateMaintainer::isClear(const Definitions::Position& pos) const
@@ -547,18 +714,79 @@ void GameStateMaintainer::resetCells(bool initializeCells)
             row.resize(m_columnsCount, Definitions::CellType::Clear);
         else
             row.resize(m_columnsCount);
+
+    m_gemIndex.reset(m_rowsCount, m_columnsCount);
+
+    std::scoped_lock lock{m_cellChangesMutex};
+    m_pendingCellChanges.reset(m_rowsCount, m_columnsCount);
 }
 
-void GameStateMaintainer::restartGame()
+void GameStateMaintainer::prepareLoad(const GameStateMaintainer& state)
+{
+    setRowsCount(state.m_rowsCount, false);
+    setColumnsCount(state.m_columnsCount, false);
+    m_gemsCount = state.m_gemsCount;
+    m_GamesDataFilesPath = state.m_GamesDataFilesPath;
+}
+
+void GameStateMaintainer::adoptLoadedLevel(GameStateMaintainer& loadState)
+{
+    if(const auto gamesGenerated {std::exchange(loadState.m_pendingGamesGenerated, std::nullopt)})
+        notifyGameGenerationCompletion(gamesGenerated.value());
+
+    if(!loadState.boardVersion())
+        return;
+
+    setRowsCount(loadState.m_rowsCount, false);
+    setColumnsCount(loadState.m_columnsCount, false);
+    m_cells = std::move(loadState.m_cells);
+    m_initialCells = std::move(loadState.m_initialCells);
+    m_currentBallPos = loadState.m_currentBallPos;
+    m_initialBallPos = loadState.m_initialBallPos;
+    m_gemsCount = loadState.m_gemsCount;
+    m_remainingGemsCount = loadState.m_remainingGemsCount;
+    m_stuckArea = std::move(loadState.m_stuckArea);
+    m_stuckAreaGems = std::move(loadState.m_stuckAreaGems);
+    m_gemIndex = std::move(loadState.m_gemIndex);
+    m_onGameStart = loadState.m_onGameStart.load();
+
+    {
+        std::scoped_lock lock{m_cellChangesMutex};
+        m_pendingCellChanges.reset(m_rowsCount, m_columnsCount);
+    }
+
+    publishBoard();
+    notifyBallPosChange(m_currentBallPos);
+}
+
+std::vector<quint32> GameStateMaintainer::restartGame()
 {
     m_currentBallPos = m_initialBallPos;
-    static_cast<InertiaModel*>(m_gameModel)->notifyBallPosChange(m_currentBallPos);
+    if(m_observer)
+        m_observer->notifyBallPosChange(m_currentBallPos);
     m_onGameStart = true;
 
-    beginResetModel();
-    m_cells = m_initialCells;
+    CellChangesBatch cellChanges{this};
+    std::vector<quint32> restoredGemCellIds;
+
+    for(const auto cellId : m_changedSinceLoad.cells())
+    {
+        const auto pos {cellPosition(cellId)};
+        const auto initialCellType {m_initialCells[pos.rowIndex][pos.columnIndex]};
+        m_cells[pos.rowIndex][pos.columnIndex] = initialCellType;
+        queueCellChange(pos);
+
+        if(initialCellType == Definitions::CellType::Gem && !m_gemIndex.contains(pos))
+        {
+            m_gemIndex.add(pos);
+            restoredGemCellIds.push_back(cellId);
+        }
+    }
+
     m_remainingGemsCount = m_gemsCount;
-    endResetModel();
+    m_changedSinceLoad.clear();
+
+    return restoredGemCellIds;
 }
 
 QString GameStateMaintainer::cellValuesToWrite() const
@@ -626,46 +854,12 @@ std::pair<bool, Definitions::Position> GameStateMaintainer::gemReachableInOneMov
 
 void GameStateMaintainer::findHintCandidateGems()
 {
-    std::unordered_set<Definitions::Position>{}.swap(m_hintCandidateGems);
-
-    const auto& gems {StateWrapper::instance().state()->gemsPositions()};
-
-    if(!m_stuckAreaGems.size())
-        m_hintCandidateGems.insert(gems.cbegin(), gems.cend());
-
-    else
-    {
-        auto gemPosesCopy {gems};
-        std::sort(gemPosesCopy.begin(), gemPosesCopy.end());
-
-        std::set_difference(gemPosesCopy.cbegin(),
-                            gemPosesCopy.cend(),
-                            m_stuckAreaGems.cbegin(),
-                            m_stuckAreaGems.cend(),
-                            std::inserter(m_hintCandidateGems, m_hintCandidateGems.end()));
-    }
-}
-
-std::unordered_set<Definitions::Position>& GameStateMaintainer::hintCandidateGems()
-{
-    return m_hintCandidateGems;
-}
-
-const std::unordered_set<Definitions::Position>& GameStateMaintainer::hintCandidateGems() const
-{
-    return m_hintCandidateGems;
+    m_gemIndex.assignRegions(m_stuckAreaGems);
 }
 
 bool GameStateMaintainer::canEnterStuckArea() const
 {
-    auto gemsPosesCopy {m_gemsPositions};
-    std::sort(gemsPosesCopy.begin(), gemsPosesCopy.end());
-
-    return std::includes(std::execution::par_unseq,
-                         m_stuckAreaGems.cbegin(),
-                         m_stuckAreaGems.cend(),
-                         gemsPosesCopy.cbegin(),
-                         gemsPosesCopy.cend());
+    return !m_gemIndex.outsideStuckAreaCount();
 }
 
 std::atomic<bool>& GameStateMaintainer::onGameStart()
@@ -746,3 +940,39 @@ void GameStateMaintainer::setGamesDataFilesPath(QString path)
 {
     m_GamesDataFilesPath = std::move(path);
 }
+
+void GameStateMaintainer::trackChangesSinceLoad()
+{
+    m_changedSinceLoad.reset(m_rowsCount, m_columnsCount);
+
+    if(m_initialCells.size() != m_rowsCount)
+        return;
+
+    for(quint32 rowIndex{}; rowIndex < m_rowsCount; ++rowIndex)
+        for(quint32 columnIndex{}; columnIndex < m_columnsCount; ++columnIndex)
+            if(m_initialCells[rowIndex].size() != m_columnsCount ||
+                m_cells[rowIndex][columnIndex] != m_initialCells[rowIndex][columnIndex])
+                m_changedSinceLoad.mark(Definitions::Position(rowIndex, columnIndex));
+}
+
+void GameStateMaintainer::invalidateBoardData()
+{
+    {
+        std::scoped_lock lock{m_cellChangesMutex};
+
+        m_boardDataHistory.clear();
+        ++m_boardDataVersion;
+    }
+
+    notifyBoardDataChange();
+}
+
+CellChangesBatch::CellChangesBatch(GameStateMaintainer* state) : m_state(state)
+{
+    m_state->beginCellChanges();
+}
+
+CellChangesBatch::~CellChangesBatch()
+{
+    m_state->endCellChanges();
+}
@@ -1,23 +1,29 @@
 #pragma once
 
-#include "game-model.hpp"
+#include "state-observer.hpp"
+#include "board-data.hpp"
+#include "gem-index.hpp"
+#include "cell-change-tracker.hpp"
+#include "board-buffers.hpp"
 
-#include <QtQml/qqmlregistration.h>
+#include <QPointF>
 
+#include <deque>
+#include <mutex>
 #include <unordered_set>
 
 
 class GameStateMaintainer : public QObject
 {
     Q_OBJECT
-    QML_ELEMENT
 
-    Q_PROPERTY(InertiaModel* model READ model WRITE setModel)
+    Q_PROPERTY(QObject* model READ model WRITE setModel)
     Q_PROPERTY(QString gamesDataFilesPath READ gamesDataFilesPath WRITE setGamesDataFilesPath FINAL)
 
 public:
 
     GameStateMaintainer(QObject* parent = nullptr);
+    explicit GameStateMaintainer(bool registerAsEngineState, QObject* parent = nullptr);
 
     GameStateMaintainer(const GameStateMaintainer&) = delete;
     GameStateMaintainer(GameStateMaintainer&&) = delete;
@@ -28,6 +34,7 @@ public:
     const std::vector<std::vector<Definitions::CellType>>& cells() const;
     Definitions::CellType& cellAt(quint32 rowIndex, quint32 columnIndex);
     const Definitions::CellType& cellAt(quint32 rowIndex, quint32 columnIndex) const;
+    void setCellType(const Definitions::Position& pos, Definitions::CellType cellType);
     std::vector<std::vector<Definitions::CellType>>& initialCells();
     const std::vector<std::vector<Definitions::CellType>>& initialCells() const;
 
@@ -35,14 +42,20 @@ public:
     quint32 columnsCount() const;
     void setRowsCount(quint32 newRowsCount, bool emitSignal = true);
     void setColumnsCount(quint32 columnsCount, bool emitSignal = true);
-    QModelIndex index(quint32 rowIndex, quint32 columnIndex);
-    QVariant data(const QModelIndex& index, int role) const;
-
-    void beginResetModel();
-    void endResetModel();
+    quint32 cellId(const Definitions::Position& pos) const;
+    Definitions::Position cellPosition(quint32 cellId) const;
+
+    void publishBoard();
+    void swapBoardBuffers();
+    const BoardBuffer& publishedBoard() const;
+    quint64 boardVersion() const;
+    quint64 boardDataVersion() const;
+    BoardData boardData(quint64 sinceVersion);
     void resetGameData(quint32 rowsCount, quint32 columnsCount);
-    void restartGame();
+    std::vector<quint32> restartGame();
     void resetCells(bool initializeCells = true);
+    void prepareLoad(const GameStateMaintainer& state);
+    void adoptLoadedLevel(GameStateMaintainer& loadState);
 
     Definitions::Position& ballPos();
     const Definitions::Position& ballPos() const;
@@ -52,18 +65,23 @@ public:
     const Definitions::Position& initialBallPos() const;
 
     void notifyBallPosChange(const Definitions::Position& ballPos);
-    void notifyDataChange(const QModelIndex& topLeft, const QModelIndex& downRight) const;
+    void beginCellChanges();
+    void endCellChanges();
+    void flushCellChanges();
+    void notifyBoardDataChange() const;
     void notifyGameGenerationCompletion(quint64 gamesGenerated);
     void notifyGameCompletion();
+    void notifySolution(const std::vector<Definitions::MovementDirection>& moves);
 
     quint32& gemsCount();
     const quint32& gemsCount() const;
-    std::vector<Definitions::Position>& gemsPositions();
+    GemIndex& gemIndex();
+    const GemIndex& gemIndex() const;
     const std::vector<Definitions::Position>& gemsPositions() const;
     quint32& remainingGemsCount();
 
 
-    void showHint(Definitions::MovementDirection moveDir);
+    void showHint(Definitions::MovementDirection moveDir, bool optimal = true);
     std::unordered_set<Definitions::Position>& stuckArea();
     const std::unordered_set<Definitions::Position>& stuckArea() const;
     std::vector<Definitions::Position>& stuckAreaGems();
@@ -77,6 +95,7 @@ public:
                                 Definitions::MovementDirection directon,
                                 bool needTrace = true,
                                 bool duringGameGeneration = false) const;
+
     bool explodesAfterPassingFrom(const Definitions::Position& currentPos) const;
     bool isClear(const Definitions::Position& pos) const;
 
@@ -87,8 +106,6 @@ public:
     QString stuckAreaGemsToWrite() const;
 
     void findHintCandidateGems();
-    std::unordered_set<Definitions::Position>& hintCandidateGems();
-    const std::unordered_set<Definitions::Position>& hintCandidateGems() const;
     bool canEnterStuckArea() const;
 
     std::atomic<bool>& onGameStart();
@@ -101,11 +118,11 @@ public:
 
 public slots:
 
-    void setModel(InertiaModel* model);
+    void setModel(QObject* model);
     void setGamesDataFilesPath(QString path);
 private:
 
-    InertiaModel* model() const;
+    QObject* model() const;
 
     const quint32& remainingGemsCount() const;
     std::optional<Definitions::CellType> nextCell(const Definitions::Position& pos,
@@ -122,18 +139,49 @@ private:
     std::pair<bool, Definitions::Position> gemReachableInOneMove(const Definitions::Position& currentPos,
                                                                    Definitions::MovementDirection MoveDir) const;
     void notifyBallPosChange(const QPointF& ballPos);
+    void trackChangesSinceLoad();
+    void queueCellChange(const Definitions::Position& pos);
+    void invalidateBoardData();
+
+    static inline constexpr std::size_t kBoardDataHistoryLength {64};
 
 
     quint32 m_rowsCount{}, m_columnsCount{};
     Definitions::Position m_currentBallPos, m_initialBallPos;
-    quint32 m_gemsCount, m_remainingGemsCount{};
+    quint32 m_gemsCount{}, m_remainingGemsCount{};
     std::vector<std::vector<Definitions::CellType>> m_cells, m_initialCells;
     std::unordered_set<Definitions::Position> m_stuckArea;
     std::vector<Definitions::Position> m_stuckAreaGems;
-    std::vector<Definitions::Position> m_gemsPositions;
-    std::unordered_set<Definitions::Position> m_hintCandidateGems;
+    GemIndex m_gemIndex;
+    CellChangeTracker m_changedSinceLoad;
+    CellChangeTracker m_pendingCellChanges;
+    quint32 m_cellChangesDepth{};
+    bool m_cellChangesFlushQueued{false};
+    mutable std::recursive_mutex m_cellChangesMutex;
+    quint64 m_boardDataVersion{};
+    std::deque<std::vector<CellRect>> m_boardDataHistory;
+    BoardBuffers m_boardBuffers;
+    std::atomic<bool> m_boardSwapQueued {false};
     std::atomic<bool> m_onGameStart {true};
+    std::atomic<quint64> m_boardVersion {};
+    std::optional<quint64> m_pendingGamesGenerated;
     QString m_GamesDataFilesPath;
-    InertiaModel* m_gameModel{};
+    StateObserver* m_observer{};
+
+};
+
+
+class CellChangesBatch
+{
+public:
+
+    explicit CellChangesBatch(GameStateMaintainer* state);
+    ~CellChangesBatch();
+
+    CellChangesBatch(const CellChangesBatch&) = delete;
+    CellChangesBatch& operator=(const CellChangesBatch&) = delete;
+
+private:
 
+    GameStateMaintainer* m_state{};
 };
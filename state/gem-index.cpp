@@ -0,0 +1,95 @@
+#include "gem-index.hpp"
+
+
+void GemIndex::reset(quint32 rowsCount, quint32 columnsCount)
+{
+    const auto cellsCount {rowsCount * columnsCount};
+
+    m_columnsCount = columnsCount;
+    m_slots.assign(cellsCount, kNoSlot);
+    m_stuckAreaGemCells.assign(cellsCount, false);
+    m_insideStuckAreaCount = 0;
+
+    m_positions.clear();
+    m_positions.reserve(cellsCount);
+}
+
+void GemIndex::assignRegions(const std::vector<Definitions::Position>& stuckAreaGems)
+{
+    m_stuckAreaGemCells.assign(m_slots.size(), false);
+    m_insideStuckAreaCount = 0;
+
+    for(const auto& pos : stuckAreaGems)
+        m_stuckAreaGemCells[cellId(pos)] = true;
+
+    for(const auto& pos : m_positions)
+        if(m_stuckAreaGemCells[cellId(pos)])
+            ++m_insideStuckAreaCount;
+}
+
+void GemIndex::add(const Definitions::Position& pos)
+{
+    const auto id {cellId(pos)};
+
+    if(m_slots[id] != kNoSlot)
+        return;
+
+    m_slots[id] = m_positions.size();
+    m_positions.push_back(pos);
+
+    if(m_stuckAreaGemCells[id])
+        ++m_insideStuckAreaCount;
+}
+
+void GemIndex::remove(const Definitions::Position& pos)
+{
+    const auto id {cellId(pos)};
+    const auto slot {m_slots[id]};
+
+    if(slot == kNoSlot)
+        return;
+
+    const auto lastPos {m_positions.back()};
+    m_slots[cellId(lastPos)] = slot;
+    m_positions[slot] = lastPos;
+    m_positions.pop_back();
+    m_slots[id] = kNoSlot;
+
+    if(m_stuckAreaGemCells[id])
+        --m_insideStuckAreaCount;
+}
+
+bool GemIndex::contains(const Definitions::Position& pos) const
+{
+    return m_slots[cellId(pos)] != kNoSlot;
+}
+
+bool GemIndex::isStuckAreaGem(const Definitions::Position& pos) const
+{
+    return m_stuckAreaGemCells[cellId(pos)];
+}
+
+const std::vector<Definitions::Position>& GemIndex::positions() const
+{
+    return m_positions;
+}
+
+quint32 GemIndex::count() const
+{
+    return m_positions.size();
+}
+
+quint32 GemIndex::insideStuckAreaCount() const
+{
+    return m_insideStuckAreaCount;
+}
+
+quint32 GemIndex::outsideStuckAreaCount() const
+{
+    return count() - m_insideStuckAreaCount;
+}
+
+quint32 GemIndex::cellId(const Definitions::Position& pos) const
+{
+    return pos.rowIndex * m_columnsCount + pos.columnIndex;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <vector>
+
+
+class GemIndex
+{
+public:
+
+    void reset(quint32 rowsCount, quint32 columnsCount);
+    void assignRegions(const std::vector<Definitions::Position>& stuckAreaGems);
+
+    void add(const Definitions::Position& pos);
+    void remove(const Definitions::Position& pos);
+    bool contains(const Definitions::Position& pos) const;
+    bool isStuckAreaGem(const Definitions::Position& pos) const;
+
+    const std::vector<Definitions::Position>& positions() const;
+    quint32 count() const;
+    quint32 insideStuckAreaCount() const;
+    quint32 outsideStuckAreaCount() const;
+
+private:
+
+    quint32 cellId(const Definitions::Position& pos) const;
+
+    static inline constexpr qint32 kNoSlot = -1;
+
+    quint32 m_columnsCount{};
+    std::vector<qint32> m_slots;
+    std::vector<bool> m_stuckAreaGemCells;
+    std::vector<Definitions::Position> m_positions;
+    quint32 m_insideStuckAreaCount{};
+};
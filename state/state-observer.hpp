@@ -0,0 +1,26 @@
+#pragma once
+
+#include "common-definitions.hpp"
+#include "cell-change-tracker.hpp"
+
+#include <QList>
+
+
+class StateObserver
+{
+public:
+
+    virtual ~StateObserver() = default;
+
+    virtual void notifyRowsCountChange(quint32 newRowsCount) = 0;
+    virtual void notifyColumnsCountChange(quint32 newColumnsCount) = 0;
+    virtual void notifyCellsChange(const CellRect& rect) = 0;
+    virtual void notifyBoardDataChange(quint64 version) = 0;
+    virtual void notifyBallPosChange(const Definitions::Position& ballPos) = 0;
+    virtual void notifyGameCompletion() = 0;
+    virtual void notifyHint(Definitions::MovementDirection moveDir, bool optimal) = 0;
+    virtual void notifyDataModificationStart() = 0;
+    virtual void notifyDataModificationEnd() = 0;
+    virtual void notifyGameGenerationCompletion(quint64 gamesGenerated) = 0;
+    virtual void notifySolution(const QList<Definitions::MovementDirection>& moves) = 0;
+};
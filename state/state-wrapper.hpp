@@ -21,7 +21,7 @@ public:
 
     inline GameStateMaintainer* state()
     {
-        return m_stateMaintainer;
+        return t_threadStateMaintainer ? t_threadStateMaintainer : m_stateMaintainer;
     }
 
     inline void setState(GameStateMaintainer* stateMaintainer)
@@ -29,9 +29,34 @@ public:
         m_stateMaintainer = stateMaintainer;
     }
 
+    inline void setThreadState(GameStateMaintainer* stateMaintainer)
+    {
+        t_threadStateMaintainer = stateMaintainer;
+    }
+
 private:
 
     StateWrapper() = default;
 
     GameStateMaintainer* m_stateMaintainer{};
+    static inline thread_local GameStateMaintainer* t_threadStateMaintainer{};
+};
+
+
+class ThreadStateScope
+{
+public:
+
+    inline explicit ThreadStateScope(GameStateMaintainer* stateMaintainer)
+    {
+        StateWrapper::instance().setThreadState(stateMaintainer);
+    }
+
+    inline ~ThreadStateScope()
+    {
+        StateWrapper::instance().setThreadState(nullptr);
+    }
+
+    ThreadStateScope(const ThreadStateScope& other) = delete;
+    ThreadStateScope& operator=(const ThreadStateScope& rhs) = delete;
 };
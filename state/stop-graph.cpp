@@ -0,0 +1,182 @@
+#include "stop-graph.hpp"
+#include "game-state-maintainer.hpp"
+#include "constants.hpp"
+
+
+void StopGraph::build(const GameStateMaintainer& state)
+{
+    build(state, state.cells());
+}
+
+void StopGraph::build(const GameStateMaintainer& state, const std::vector<std::vector<Definitions::CellType>>& cells)
+{
+    m_slides.clear();
+    m_coveredCells.clear();
+
+    m_columnsCount = state.columnsCount();
+    m_cellsCount = state.rowsCount() * m_columnsCount;
+    m_slides.reserve(m_cellsCount * kDirectionsCount);
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+    {
+        const auto sourcePos {state.cellPosition(cellId)};
+
+        for(const auto direction : Constants::kAllDirections)
+            m_slides.push_back(buildSlide(state, cells, sourcePos, direction));
+    }
+
+    buildArrivals();
+    buildCoverers();
+}
+
+void StopGraph::clear()
+{
+    m_columnsCount = 0;
+    m_cellsCount = 0;
+    std::vector<Slide>{}.swap(m_slides);
+    std::vector<quint32>{}.swap(m_coveredCells);
+    std::vector<quint32>{}.swap(m_arrivalsOffsets);
+    std::vector<SlideRef>{}.swap(m_arrivals);
+    std::vector<quint32>{}.swap(m_coverersOffsets);
+    std::vector<SlideRef>{}.swap(m_coverers);
+}
+
+bool StopGraph::isBuilt() const
+{
+    return m_cellsCount;
+}
+
+quint32 StopGraph::cellsCount() const
+{
+    return m_cellsCount;
+}
+
+quint32 StopGraph::columnsCount() const
+{
+    return m_columnsCount;
+}
+
+std::size_t StopGraph::allocatedBytes() const
+{
+    return m_slides.capacity() * sizeof(Slide) +
+           (m_coveredCells.capacity() + m_arrivalsOffsets.capacity() + m_coverersOffsets.capacity()) * sizeof(quint32) +
+           (m_arrivals.capacity() + m_coverers.capacity()) * sizeof(SlideRef);
+}
+
+const StopGraph::Slide& StopGraph::slide(quint32 cellId, std::size_t directionIndex) const
+{
+    return m_slides[cellId * kDirectionsCount + directionIndex];
+}
+
+std::span<const quint32> StopGraph::coveredCells(const Slide& slide) const
+{
+    return {m_coveredCells.data() + slide.coveredBegin, m_coveredCells.data() + slide.coveredEnd};
+}
+
+std::span<const StopGraph::SlideRef> StopGraph::arrivals(quint32 cellId) const
+{
+    return {m_arrivals.data() + m_arrivalsOffsets[cellId], m_arrivals.data() + m_arrivalsOffsets[cellId + 1]};
+}
+
+std::span<const StopGraph::SlideRef> StopGraph::coverers(quint32 cellId) const
+{
+    return {m_coverers.data() + m_coverersOffsets[cellId], m_coverers.data() + m_coverersOffsets[cellId + 1]};
+}
+
+bool StopGraph::isMove(quint32 cellId, std::size_t directionIndex) const
+{
+    const auto& currentSlide {slide(cellId, directionIndex)};
+    return currentSlide.safe && currentSlide.destination != cellId;
+}
+
+StopGraph::Slide StopGraph::buildSlide(const GameStateMaintainer& state,
+                                       const std::vector<std::vector<Definitions::CellType>>& cells,
+                                       const Definitions::Position& sourcePos,
+                                       Definitions::MovementDirection direction)
+{
+    Slide result{state.cellId(sourcePos), false, static_cast<quint32>(m_coveredCells.size())};
+    result.coveredEnd = result.coveredBegin;
+
+    const auto sourceCell {cells[sourcePos.rowIndex][sourcePos.columnIndex]};
+
+    if(sourceCell == Definitions::CellType::Wall || sourceCell == Definitions::CellType::Mine)
+        return result;
+
+    auto startPos {sourcePos};
+    std::optional<Definitions::Position> nextPos;
+
+    while(true)
+    {
+        nextPos = state.nextCellPos(startPos, direction);
+
+        if(!nextPos)
+            break;
+
+        const auto nextCell {cells[nextPos->rowIndex][nextPos->columnIndex]};
+
+        if(nextCell == Definitions::CellType::Wall)
+            break;
+
+        if(nextCell == Definitions::CellType::Mine)
+        {
+            m_coveredCells.resize(result.coveredBegin);
+            return result;
+        }
+
+        m_coveredCells.push_back(state.cellId(nextPos.value()));
+        startPos = nextPos.value();
+
+        if(nextCell == Definitions::CellType::Stop)
+            break;
+    }
+
+    result.destination = state.cellId(startPos);
+    result.safe = true;
+    result.coveredEnd = m_coveredCells.size();
+
+    return result;
+}
+
+void StopGraph::buildArrivals()
+{
+    m_arrivalsOffsets.assign(m_cellsCount + 1, 0);
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        for(std::size_t dirIndex{}; dirIndex < kDirectionsCount; ++dirIndex)
+            if(isMove(cellId, dirIndex))
+                ++m_arrivalsOffsets[slide(cellId, dirIndex).destination + 1];
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        m_arrivalsOffsets[cellId + 1] += m_arrivalsOffsets[cellId];
+
+    m_arrivals.resize(m_arrivalsOffsets.back());
+    auto insertPositions {m_arrivalsOffsets};
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        for(std::size_t dirIndex{}; dirIndex < kDirectionsCount; ++dirIndex)
+            if(isMove(cellId, dirIndex))
+                m_arrivals[insertPositions[slide(cellId, dirIndex).destination]++] = {cellId, static_cast<quint8>(dirIndex)};
+}
+
+void StopGraph::buildCoverers()
+{
+    m_coverersOffsets.assign(m_cellsCount + 1, 0);
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        for(std::size_t dirIndex{}; dirIndex < kDirectionsCount; ++dirIndex)
+            if(isMove(cellId, dirIndex))
+                for(const auto coveredCell : coveredCells(slide(cellId, dirIndex)))
+                    ++m_coverersOffsets[coveredCell + 1];
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        m_coverersOffsets[cellId + 1] += m_coverersOffsets[cellId];
+
+    m_coverers.resize(m_coverersOffsets.back());
+    auto insertPositions {m_coverersOffsets};
+
+    for(quint32 cellId{}; cellId < m_cellsCount; ++cellId)
+        for(std::size_t dirIndex{}; dirIndex < kDirectionsCount; ++dirIndex)
+            if(isMove(cellId, dirIndex))
+                for(const auto coveredCell : coveredCells(slide(cellId, dirIndex)))
+                    m_coverers[insertPositions[coveredCell]++] = {cellId, static_cast<quint8>(dirIndex)};
+}
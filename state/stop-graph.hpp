@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common-definitions.hpp"
+
+#include <span>
+#include <vector>
+
+
+class GameStateMaintainer;
+
+
+class StopGraph
+{
+public:
+
+    struct Slide
+    {
+        quint32 destination{};
+        bool safe{false};
+        quint32 coveredBegin{};
+        quint32 coveredEnd{};
+    };
+
+    struct SlideRef
+    {
+        quint32 sourceCellId{};
+        quint8 directionIndex{};
+    };
+
+    static inline constexpr std::size_t kDirectionsCount = 8;
+
+    void build(const GameStateMaintainer& state);
+    void build(const GameStateMaintainer& state, const std::vector<std::vector<Definitions::CellType>>& cells);
+    void clear();
+
+    bool isBuilt() const;
+    quint32 cellsCount() const;
+    quint32 columnsCount() const;
+    std::size_t allocatedBytes() const;
+
+    const Slide& slide(quint32 cellId, std::size_t directionIndex) const;
+    std::span<const quint32> coveredCells(const Slide& slide) const;
+    std::span<const SlideRef> arrivals(quint32 cellId) const;
+    std::span<const SlideRef> coverers(quint32 cellId) const;
+
+    bool isMove(quint32 cellId, std::size_t directionIndex) const;
+
+private:
+
+    Slide buildSlide(const GameStateMaintainer& state,
+                       const std::vector<std::vector<Definitions::CellType>>& cells,
+                       const Definitions::Position& sourcePos,
+                       Definitions::MovementDirection direction);
+
+    void buildArrivals();
+    void buildCoverers();
+
+    quint32 m_columnsCount{}, m_cellsCount{};
+    std::vector<Slide> m_slides;
+    std::vector<quint32> m_coveredCells;
+    std::vector<quint32> m_arrivalsOffsets;
+    std::vector<SlideRef> m_arrivals;
+    std::vector<quint32> m_coverersOffsets;
+    std::vector<SlideRef> m_coverers;
+};
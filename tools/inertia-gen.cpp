@@ -0,0 +1,391 @@
+#include "state-wrapper.hpp"
+#include "game-generator/game-generator.hpp"
+#include "game-generator/level-metrics.hpp"
+#include "game-generator/pack-index.hpp"
+#include "service/engine-trace.hpp"
+#include "utility.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <mutex>
+
+
+class BatchGenerator
+{
+public:
+
+    enum class Format
+    {
+        Pack,
+        JsonLines
+    };
+
+    struct Options
+    {
+        quint32 rowsCount{};
+        quint32 columnsCount{};
+        quint64 gamesCount{};
+        quint32 threadsCount{};
+        quint32 seed{};
+        QString outputPath;
+        QString tracePath;
+        Format format{Format::Pack};
+    };
+
+    explicit BatchGenerator(Options options);
+
+    int run();
+
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    void resume();
+    std::pair<quint32, quint32> firstLevelSize(const QString& data) const;
+    void rebuildPackIndex(const QString& packData);
+    void work(quint32 workerIndex);
+    std::optional<quint64> claimChunk();
+    QByteArray toJsonLines(GameGenerator& generator, const QString& packData, const PackIndex& packIndex) const;
+    void appendChunk(const QByteArray& data, const PackIndex& packIndex, quint64 gamesCount);
+    void reportProgress() const;
+
+    static inline constexpr quint64 kMaxChunkGamesCount {1000};
+
+    Options m_options;
+    quint64 m_chunkGamesCount{};
+    QFile m_output;
+    PackIndex m_packIndex;
+    quint64 m_resumedGamesCount{};
+    quint64 m_writtenGamesCount{};
+    std::atomic<quint64> m_claimedGamesCount{};
+    std::atomic<bool> m_failed{false};
+    std::mutex m_outputMutex;
+    Clock::time_point m_start;
+};
+
+BatchGenerator::BatchGenerator(Options options) : m_options(std::move(options)),
+                                                   m_output(m_options.outputPath)
+{
+    m_chunkGamesCount = std::clamp<quint64>(m_options.gamesCount / (m_options.threadsCount * 8ULL), 1, kMaxChunkGamesCount);
+}
+
+int BatchGenerator::run()
+{
+    resume();
+
+    if(!m_output.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        std::fprintf(stderr, "Could not open %s for writing\n", qPrintable(m_options.outputPath));
+        return 1;
+    }
+
+    m_claimedGamesCount = m_writtenGamesCount;
+    m_start = Clock::now();
+
+    if(m_options.tracePath.size())
+        EngineTrace::instance().start();
+
+    std::vector<std::unique_ptr<QThread>> workers;
+
+    for(quint32 workerIndex{}; workerIndex < m_options.threadsCount; ++workerIndex)
+    {
+        workers.emplace_back(QThread::create([this, workerIndex]
+        {
+            work(workerIndex);
+        }));
+
+        workers.back()->setObjectName(QString("Generator worker %1").arg(workerIndex));
+        workers.back()->start();
+    }
+
+    for(auto& worker : workers)
+        worker->wait();
+
+    m_output.close();
+    std::fputc('\n', stderr);
+
+    if(m_options.tracePath.size())
+        EngineTrace::instance().stop(m_options.tracePath);
+
+    if(m_failed)
+        return 1;
+
+    if(m_options.format == Format::Pack)
+        m_packIndex.save(PackIndex::indexPathFor(m_options.outputPath));
+
+    return 0;
+}
+
+void BatchGenerator::resume()
+{
+    if(!m_output.exists())
+        return;
+
+    if(!m_output.open(QIODevice::ReadWrite))
+        throw std::runtime_error{std::format("Could not open the file {} for resuming", m_options.outputPath.toStdString())};
+
+    auto data {QString::fromLatin1(m_output.readAll())};
+    const auto terminator {m_options.format == Format::Pack ? '#' : '\n'};
+    const auto completeLength {data.lastIndexOf(terminator) + 1};
+
+    data.truncate(completeLength);
+    m_output.resize(completeLength);
+    m_output.close();
+
+    m_writtenGamesCount = data.count(terminator);
+    m_resumedGamesCount = m_writtenGamesCount;
+
+    if(!m_writtenGamesCount)
+        return;
+
+    if(const auto [rowsCount, columnsCount] {firstLevelSize(data)};
+        rowsCount != m_options.rowsCount || columnsCount != m_options.columnsCount)
+        throw std::runtime_error{std::format("The file {} holds {}x{} levels, cannot resume it with {}x{}",
+                                             m_options.outputPath.toStdString(),
+                                             rowsCount,
+                                             columnsCount,
+                                             m_options.rowsCount,
+                                             m_options.columnsCount)};
+
+    if(m_options.format != Format::Pack)
+        return;
+
+    const auto packIndex {PackIndex::load(PackIndex::indexPathFor(m_options.outputPath))};
+
+    if(packIndex && packIndex->size() == m_writtenGamesCount)
+        m_packIndex = packIndex.value();
+
+    else
+        rebuildPackIndex(data + ' ');
+}
+
+std::pair<quint32, quint32> BatchGenerator::firstLevelSize(const QString& data) const
+{
+    if(m_options.format == Format::JsonLines)
+    {
+        const auto level {QJsonDocument::fromJson(data.section('\n', 0, 0).toLatin1()).object()};
+        return {static_cast<quint32>(level["rows"].toInteger()), static_cast<quint32>(level["columns"].toInteger())};
+    }
+
+    auto gameData {data.section('#', 0, 0)};
+    QTextStream stream{&gameData};
+    quint32 rowsCount{}, columnsCount{};
+    stream >> rowsCount >> columnsCount;
+
+    return {rowsCount, columnsCount};
+}
+
+void BatchGenerator::rebuildPackIndex(const QString& packData)
+{
+    GameStateMaintainer state{false};
+    const ThreadStateScope threadState {&state};
+
+    GameGenerator generator;
+    LevelMeter levelMeter;
+    const auto gamesData {GameGenerator::splitPackEntries(packData)};
+
+    for(qsizetype entryIndex{}; entryIndex < gamesData.size(); ++entryIndex)
+    {
+        generator.loadPackEntry(m_options.rowsCount, m_options.columnsCount, gamesData[entryIndex]);
+        m_packIndex.add(entryIndex, levelMeter.measure(state, state.cells(), state.ballPos(), state.stuckArea().size()));
+    }
+}
+
+void BatchGenerator::work(quint32 workerIndex)
+{
+    GameStateMaintainer state{false};
+    state.setRowsCount(m_options.rowsCount, false);
+    state.setColumnsCount(m_options.columnsCount, false);
+    const ThreadStateScope threadState {&state};
+    InertiaUtility::seedRandomEngine(m_options.seed + workerIndex);
+
+    GameGenerator generator;
+
+    try
+    {
+        while(const auto claimedGamesCount {claimChunk()})
+        {
+            QString packData;
+            quint64 gamesCount{};
+
+            {
+                QTextStream stream{&packData};
+                gamesCount = generator.generateGames(stream, claimedGamesCount.value());
+            }
+
+            if(m_options.format == Format::Pack)
+                appendChunk(packData.toLatin1(), generator.packIndex(), gamesCount);
+
+            else
+                appendChunk(toJsonLines(generator, packData, generator.packIndex()), {}, gamesCount);
+
+            if(gamesCount < claimedGamesCount.value())
+                m_claimedGamesCount -= claimedGamesCount.value() - gamesCount;
+        }
+    }
+
+    catch(const std::exception& exception)
+    {
+        std::fprintf(stderr, "\nWorker %u failed: %s\n", workerIndex, exception.what());
+        m_failed = true;
+    }
+}
+
+std::optional<quint64> BatchGenerator::claimChunk()
+{
+    auto claimedGamesCount {m_claimedGamesCount.load()};
+
+    while(!m_failed && claimedGamesCount < m_options.gamesCount)
+    {
+        const auto gamesCount {std::min(m_chunkGamesCount, m_options.gamesCount - claimedGamesCount)};
+
+        if(m_claimedGamesCount.compare_exchange_weak(claimedGamesCount, claimedGamesCount + gamesCount))
+            return gamesCount;
+    }
+
+    return {};
+}
+
+QByteArray BatchGenerator::toJsonLines(GameGenerator& generator, const QString& packData, const PackIndex& packIndex) const
+{
+    const auto gamesData {GameGenerator::splitPackEntries(packData)};
+    std::vector<LevelMetrics> metrics(gamesData.size());
+
+    for(const auto& [entryIndex, entryMetrics] : packIndex.entries())
+        if(entryIndex < metrics.size())
+            metrics[entryIndex] = entryMetrics;
+
+    const auto state {StateWrapper::instance().state()};
+    QByteArray result;
+
+    for(qsizetype entryIndex{}; entryIndex < gamesData.size(); ++entryIndex)
+    {
+        generator.loadPackEntry(m_options.rowsCount, m_options.columnsCount, gamesData[entryIndex]);
+
+        QByteArray cells;
+        cells.reserve(state->rowsCount() * state->columnsCount());
+
+        for(const auto& row : state->cells())
+            for(const auto cellType : row)
+                cells.append(static_cast<char>('0' + cellType));
+
+        const auto& levelMetrics {metrics[entryIndex]};
+
+        QJsonObject level;
+        level["rows"] = static_cast<qint64>(state->rowsCount());
+        level["columns"] = static_cast<qint64>(state->columnsCount());
+        level["ball"] = QJsonArray{static_cast<qint64>(state->ballPos().rowIndex), static_cast<qint64>(state->ballPos().columnIndex)};
+        level["cells"] = QString::fromLatin1(cells);
+        level["optimalMovesCount"] = levelMetrics.optimalMovesCount;
+        level["branchingFactor"] = levelMetrics.branchingFactor;
+        level["restCellsCount"] = static_cast<qint64>(levelMetrics.restCellsCount);
+        level["stuckAreaSize"] = static_cast<qint64>(levelMetrics.stuckAreaSize);
+        level["minesNearPathsCount"] = static_cast<qint64>(levelMetrics.minesNearPathsCount);
+
+        result.append(QJsonDocument{level}.toJson(QJsonDocument::Compact));
+        result.append('\n');
+    }
+
+    return result;
+}
+
+void BatchGenerator::appendChunk(const QByteArray& data, const PackIndex& packIndex, quint64 gamesCount)
+{
+    std::scoped_lock lock{m_outputMutex};
+
+    if(m_output.write(data) != data.size() || !m_output.flush())
+        throw std::runtime_error{std::format("Could not write into the file {}", m_options.outputPath.toStdString())};
+
+    for(const auto& [entryIndex, metrics] : packIndex.entries())
+        m_packIndex.add(m_writtenGamesCount + entryIndex, metrics);
+
+    m_writtenGamesCount += gamesCount;
+    reportProgress();
+}
+
+void BatchGenerator::reportProgress() const
+{
+    const auto elapsed {std::chrono::duration<double>(Clock::now() - m_start).count()};
+    const auto generatedGamesCount {m_writtenGamesCount - m_resumedGamesCount};
+
+    std::fprintf(stderr,
+                 "\r%llu/%llu levels, %.1f levels/s",
+                 static_cast<unsigned long long>(m_writtenGamesCount),
+                 static_cast<unsigned long long>(m_options.gamesCount),
+                 elapsed > 0 ? generatedGamesCount / elapsed : 0.0);
+}
+
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication application{argc, argv};
+    QCoreApplication::setApplicationName("inertia-gen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates Inertia levels into a pack file");
+    parser.addHelpOption();
+
+    const QCommandLineOption rowsOption{"rows", "Board rows count.", "rows"};
+    const QCommandLineOption columnsOption{"cols", "Board columns count.", "cols"};
+    const QCommandLineOption countOption{"count", "Levels count to have in the output.", "count"};
+    const QCommandLineOption threadsOption{"threads", "Generator threads count.", "threads", QString::number(QThread::idealThreadCount())};
+    const QCommandLineOption seedOption{"seed", "Random seed of the first generator thread.", "seed"};
+    const QCommandLineOption outputOption{"out", "Output file, resumed when it already exists.", "path"};
+    const QCommandLineOption formatOption{"format", "Output format: pack or jsonl.", "format", "pack"};
+    const QCommandLineOption traceOption{"trace", "Trace-event file to record the engine phases into.", "path"};
+
+    parser.addOptions({rowsOption, columnsOption, countOption, threadsOption, seedOption, outputOption, formatOption, traceOption});
+    parser.process(application);
+
+    BatchGenerator::Options options;
+    bool rowsValid{}, columnsValid{}, countValid{}, threadsValid{}, seedValid{true};
+
+    options.rowsCount = parser.value(rowsOption).toUInt(&rowsValid);
+    options.columnsCount = parser.value(columnsOption).toUInt(&columnsValid);
+    options.gamesCount = parser.value(countOption).toULongLong(&countValid);
+    options.threadsCount = parser.value(threadsOption).toUInt(&threadsValid);
+    options.seed = parser.isSet(seedOption) ? parser.value(seedOption).toUInt(&seedValid) : std::random_device{}();
+    options.outputPath = parser.value(outputOption);
+    options.tracePath = parser.value(traceOption);
+
+    if(parser.value(formatOption) == "jsonl")
+        options.format = BatchGenerator::Format::JsonLines;
+
+    else if(parser.value(formatOption) != "pack")
+    {
+        std::fprintf(stderr, "Unknown format %s\n", qPrintable(parser.value(formatOption)));
+        return 2;
+    }
+
+    if(!rowsValid || !columnsValid || !countValid || !threadsValid || !seedValid ||
+        !options.rowsCount || !options.columnsCount || !options.threadsCount || options.outputPath.isEmpty())
+    {
+        std::fprintf(stderr, "%s", qPrintable(parser.helpText()));
+        return 2;
+    }
+
+    if(options.tracePath.size() && !EngineTrace::kEnabled)
+        std::fprintf(stderr, "Built without INERTIA_ENABLE_TRACE, the trace will be empty\n");
+
+    try
+    {
+        return BatchGenerator{std::move(options)}.run();
+    }
+
+    catch(const std::exception& exception)
+    {
+        std::fprintf(stderr, "%s\n", exception.what());
+        return 1;
+    }
+}
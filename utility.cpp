@@ -1,7 +1,7 @@
 #include "utility.hpp"
 #include "constants.hpp"
 
-#include <random>
+#include <algorithm>
 
 
 namespace InertiaUtility
@@ -83,27 +83,32 @@ namespace InertiaUtility
                          std::pow(static_cast<qint32>(pos2.columnIndex) - static_cast<qint32>(pos1.columnIndex), 2));
     }
 
+    std::mt19937& randomEngine()
+    {
+        static thread_local std::mt19937 engine{std::random_device{}()};
+        return engine;
+    }
+
+    void seedRandomEngine(quint32 seed)
+    {
+        randomEngine().seed(seed);
+    }
+
     quint32 randomRowIndex(quint32 rowsCounts)
     {
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        return generator() % rowsCounts;
+        return randomEngine()() % rowsCounts;
     }
 
     quint32 randomColumnIndex(quint32 columnsCounts)
     {
-        std::random_device rd;
-        std::mt19937 generator(rd());
-        return generator() % columnsCounts;
+        return randomEngine()() % columnsCounts;
     }
 
     std::vector<Definitions::MovementDirection> shuffledDirections()
     {
-        std::random_device rd;
-        std::mt19937 generator(rd());
         auto shuffledDirs {Constants::kAllDirections};
 
-        std::shuffle(shuffledDirs.begin(), shuffledDirs.end(), generator);
+        std::shuffle(shuffledDirs.begin(), shuffledDirs.end(), randomEngine());
         return shuffledDirs;
     }
 
@@ -216,4 +221,10 @@ namespace InertiaUtility
                 intValue == 270 ||
                 intValue == 315);
     }
+
+    std::size_t directionIndex(Definitions::MovementDirection direction)
+    {
+        return std::find(Constants::kAllDirections.cbegin(), Constants::kAllDirections.cend(), direction) -
+               Constants::kAllDirections.cbegin();
+    }
 }
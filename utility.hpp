@@ -2,6 +2,8 @@
 
 #include "common-definitions.hpp"
 
+#include <random>
+
 
 namespace InertiaUtility
 {
@@ -11,6 +13,8 @@ namespace InertiaUtility
                                                       quint32 targetColumnIndex);
 
     double distance(const Definitions::Position& pos1, const Definitions::Position& pos2);
+    std::mt19937& randomEngine();
+    void seedRandomEngine(quint32 seed);
     quint32 randomRowIndex(quint32 rowsCounts);
     quint32 randomColumnIndex(quint32 columnsCounts);
 
@@ -23,4 +27,5 @@ namespace InertiaUtility
 
     Definitions::Hint directionToHint(Definitions::MovementDirection direction);
     bool isValidDirection(Definitions::MovementDirection direction);
+    std::size_t directionIndex(Definitions::MovementDirection direction);
 };
@@ -0,0 +1,131 @@
+#include "board-item.hpp"
+
+#include <QQuickWindow>
+#include <QSGSimpleTextureNode>
+
+
+BoardItem::BoardItem(QQuickItem* parent) : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setCellColors(kDefaultCellColors);
+}
+
+InertiaModel* BoardItem::model() const
+{
+    return m_model;
+}
+
+void BoardItem::setModel(InertiaModel* model)
+{
+    if(m_model == model)
+        return;
+
+    if(m_model)
+        disconnect(m_model, nullptr, this, nullptr);
+
+    m_model = model;
+
+    if(m_model)
+    {
+        connect(m_model, &InertiaModel::boardDataChanged, this, &BoardItem::onBoardDataChanged);
+        connect(m_model, &QAbstractItemModel::modelReset, this, &BoardItem::reloadBoard);
+    }
+
+    reloadBoard();
+    emit modelChanged();
+}
+
+QList<QColor> BoardItem::cellColors() const
+{
+    return m_cellColors;
+}
+
+void BoardItem::setCellColors(const QList<QColor>& cellColors)
+{
+    m_cellColors = cellColors;
+    m_cellPalette.clear();
+
+    for(qsizetype code{}; code < kDefaultCellColors.size(); ++code)
+        m_cellPalette.push_back(code < m_cellColors.size() ? m_cellColors[code].rgba() : kDefaultCellColors[code].rgba());
+
+    reloadBoard();
+    emit cellColorsChanged();
+}
+
+QSGNode* BoardItem::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* updatePaintNodeData)
+{
+    Q_UNUSED(updatePaintNodeData);
+
+    auto node {static_cast<QSGSimpleTextureNode*>(oldNode)};
+
+    if(m_cellsImage.isNull() || !window())
+    {
+        delete node;
+        return nullptr;
+    }
+
+    if(!node)
+    {
+        node = new QSGSimpleTextureNode;
+        node->setOwnsTexture(true);
+        m_textureDirty = true;
+    }
+
+    if(m_textureDirty)
+    {
+        m_textureDirty = false;
+        node->setTexture(window()->createTextureFromImage(m_cellsImage));
+        node->setFiltering(QSGTexture::Nearest);
+    }
+
+    node->setRect(boundingRect());
+
+    return node;
+}
+
+void BoardItem::onBoardDataChanged()
+{
+    if(!m_model)
+        return;
+
+    const auto boardData {m_model->boardData(m_boardDataVersion)};
+
+    if(boardData.fullUpdate() ||
+        m_cellsImage.width() != static_cast<qint32>(boardData.columnsCount()) ||
+        m_cellsImage.height() != static_cast<qint32>(boardData.rowsCount()))
+    {
+        m_cellsImage = QImage(boardData.columnsCount(), boardData.rowsCount(), QImage::Format_ARGB32);
+        paintCells(boardData.cells(), m_cellsImage.rect());
+    }
+
+    else
+        for(const auto& rect : boardData.changedRanges())
+            paintCells(boardData.cells(), rect);
+
+    m_boardDataVersion = boardData.version();
+    m_textureDirty = true;
+    update();
+}
+
+void BoardItem::paintCells(const QByteArray& cells, const QRect& rect)
+{
+    const auto columnsCount {m_cellsImage.width()};
+
+    for(auto rowIndex {rect.top()}; rowIndex <= rect.bottom(); ++rowIndex)
+    {
+        auto line {reinterpret_cast<QRgb*>(m_cellsImage.scanLine(rowIndex))};
+
+        for(auto columnIndex {rect.left()}; columnIndex <= rect.right(); ++columnIndex)
+            line[columnIndex] = m_cellPalette[static_cast<quint8>(cells[rowIndex * columnsCount + columnIndex])];
+    }
+}
+
+void BoardItem::reloadBoard()
+{
+    m_boardDataVersion = 0;
+    m_cellsImage = {};
+    onBoardDataChanged();
+
+    if(!m_model)
+        update();
+}
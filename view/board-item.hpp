@@ -0,0 +1,61 @@
+#pragma once
+
+#include "game-model.hpp"
+
+#include <QQuickItem>
+#include <QPointer>
+#include <QImage>
+#include <QColor>
+#include <QtQml/qqmlregistration.h>
+
+
+class BoardItem : public QQuickItem
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(InertiaModel* model READ model WRITE setModel NOTIFY modelChanged FINAL)
+    Q_PROPERTY(QList<QColor> cellColors READ cellColors WRITE setCellColors NOTIFY cellColorsChanged FINAL)
+
+public:
+
+    explicit BoardItem(QQuickItem* parent = nullptr);
+
+    InertiaModel* model() const;
+    void setModel(InertiaModel* model);
+    QList<QColor> cellColors() const;
+    void setCellColors(const QList<QColor>& cellColors);
+
+signals:
+
+    void modelChanged();
+    void cellColorsChanged();
+
+protected:
+
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* updatePaintNodeData) override;
+
+private slots:
+
+    void onBoardDataChanged();
+
+private:
+
+    void paintCells(const QByteArray& cells, const QRect& rect);
+    void reloadBoard();
+
+    static inline const QList<QColor> kDefaultCellColors {QColor(0xf0, 0xf0, 0xf0),
+                                                           QColor(0xf0, 0xf0, 0xf0),
+                                                           QColor(0x5d, 0x40, 0x37),
+                                                           QColor(0x90, 0xa4, 0xae),
+                                                           QColor(0x26, 0xc6, 0xda),
+                                                           QColor(0xe5, 0x39, 0x35),
+                                                           QColor(0x21, 0x21, 0x21)};
+
+    QPointer<InertiaModel> m_model;
+    QList<QColor> m_cellColors {kDefaultCellColors};
+    QList<QRgb> m_cellPalette;
+    QImage m_cellsImage;
+    quint64 m_boardDataVersion{};
+    bool m_textureDirty{false};
+};